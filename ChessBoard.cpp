@@ -1,5 +1,14 @@
 #include "ChessBoard.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
 #include "Transform.hpp"
+#include "engine/Attacks.hpp"
+#include "engine/Instrumentation.hpp"
+#include "engine/Prng.hpp"
+#include "engine/QueenSolver.hpp"
+#include "engine/Zobrist.hpp"
 /**
 Name: Kenny Zhou
 Date: 4/25/25
@@ -37,7 +46,7 @@ Purpose: The cpp file for ChessBoard. Implements queenHelper, findAllQueenReplac
     * 3) p1_color is set to "BLACK", and p2_color is set to "WHITE"
     */
 ChessBoard::ChessBoard() 
-    : playerOneTurn{true}, p1_color{"BLACK"}, p2_color{"WHITE"}, board{std::vector(8, std::vector<ChessPiece*>(8)) } {
+    : playerOneTurn{true}, p1_color{"BLACK"}, p2_color{"WHITE"}, board{std::vector(BOARD_LENGTH, std::vector<ChessPiece*>(BOARD_LENGTH)) } {
         // Allocate pieces
 
         auto add_mirrored = [this] (const int& i, const std::string& type) {
@@ -67,6 +76,8 @@ ChessBoard::ChessBoard()
             add_mirrored(i, "PAWN");
             add_mirrored(i, inner_pieces[i]);
         }
+
+        syncFromBoard();
     }
 
 /**
@@ -78,7 +89,9 @@ ChessBoard::ChessBoard()
  * @post Initializes the board layout, sets player one's color to "BLACK" and player two's color to "WHITE".
  */
 ChessBoard::ChessBoard(const std::vector<std::vector<ChessPiece*>>& instance, const bool& p1Turn)
- : playerOneTurn{p1Turn}, p1_color{"BLACK"}, p2_color{"WHITE"}, board{instance}{}
+ : playerOneTurn{p1Turn}, p1_color{"BLACK"}, p2_color{"WHITE"}, board{instance} {
+    syncFromBoard();
+}
 
 /**
  * @brief Gets the ChessPiece (if any) at (row, col) on the board
@@ -96,6 +109,32 @@ ChessPiece* ChessBoard::getCell(const int& row, const int& col) const {
  * @post Deallocates all ChessPiece pointers stored on the board at time of deletion. 
  */
 ChessBoard::~ChessBoard() {
+    releasePieces();
+}
+
+/**
+ * @brief Copy constructor. Every piece on the board, and every piece parked in the move history, is cloned,
+ *        so the copy owns its own pieces and can unmake the moves made on the original.
+ */
+ChessBoard::ChessBoard(const ChessBoard& other) {
+    copyFrom(other);
+}
+
+/**
+ * @brief Copy assignment. Releases this board's pieces, then clones the other board's (see the copy constructor).
+ */
+ChessBoard& ChessBoard::operator=(const ChessBoard& other) {
+    if (this != &other) {
+        releasePieces();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+/**
+ * @brief Deletes every piece owned by the board: those on it, and those parked in the move history
+ */
+void ChessBoard::releasePieces() {
     for (int i = 0; i < BOARD_LENGTH; i++) {
         for (int j = 0; j < BOARD_LENGTH; j++) {
             if (!board[i][j]) { continue; }
@@ -103,12 +142,1101 @@ ChessBoard::~ChessBoard() {
             board[i][j] = nullptr;
         }
     }
+
+    // Pieces that are off the board because of moves that were never unmade
+    for (size_t i = 0; i < history.size(); i++) {
+        delete history[i].capturedPiece;
+        delete history[i].promotedPawn;
+    }
+    history.clear();
+}
+
+/**
+ * @brief Copies the other board's state into this one, cloning every piece it owns
+ * @pre This board owns no pieces
+ */
+void ChessBoard::copyFrom(const ChessBoard& other) {
+    playerOneTurn = other.playerOneTurn;
+    p1_color = other.p1_color;
+    p2_color = other.p2_color;
+
+    board.assign(BOARD_LENGTH, std::vector<ChessPiece*>(BOARD_LENGTH, nullptr));
+    for (int i = 0; i < BOARD_LENGTH; i++) {
+        for (int j = 0; j < BOARD_LENGTH; j++) {
+            board[i][j] = clonePiece(other.board[i][j]);
+        }
+    }
+
+    history = other.history;
+    for (size_t i = 0; i < history.size(); i++) {
+        history[i].capturedPiece = clonePiece(other.history[i].capturedPiece);
+        history[i].promotedPawn = clonePiece(other.history[i].promotedPawn);
+    }
+
+    std::copy(&other.pieceBoards[0][0], &other.pieceBoards[0][0] + SIDE_COUNT * PIECE_KIND_COUNT, &pieceBoards[0][0]);
+    std::copy(other.sideBoards, other.sideBoards + SIDE_COUNT, sideBoards);
+    std::copy(other.mailbox, other.mailbox + Bitboards::SQUARE_COUNT, mailbox);
+    std::copy(other.squareAttacks, other.squareAttacks + Bitboards::SQUARE_COUNT, squareAttacks);
+    std::copy(other.attackMaps, other.attackMaps + SIDE_COUNT, attackMaps);
+    occupancy = other.occupancy;
+    castlingRights = other.castlingRights;
+    enPassantSquare = other.enPassantSquare;
+    halfmoveClock = other.halfmoveClock;
+    fullmoveNumber = other.fullmoveNumber;
+    zobristKey = other.zobristKey;
+    middlegameScore = other.middlegameScore;
+    endgameScore = other.endgameScore;
+    gamePhase = other.gamePhase;
+}
+
+/**
+ * @brief Allocates a copy of a piece (including its moved flag), or returns nullptr for nullptr
+ */
+ChessPiece* ChessBoard::clonePiece(const ChessPiece* piece) {
+    if (!piece) { return nullptr; }
+
+    int kind = kindOf(*piece);
+    ChessPiece* copy = nullptr;
+    if (kind == ROOK_KIND) {
+        const Rook& rook = static_cast<const Rook&>(*piece);
+        copy = new Rook(rook.getColor(), rook.getRow(), rook.getColumn(), rook.isMovingUp(), rook.getCastleMovesLeft());
+    } else {
+        copy = createPiece(kind, piece->getColor(), piece->getRow(), piece->getColumn(), piece->isMovingUp());
+    }
+    if (copy) { copy->setMoved(piece->hasMoved()); }
+    return copy;
+}
+
+namespace {
+    // Home cells used by castling. Both Kings start on column 3 (see the default constructor).
+    const int KING_HOME_COL = 3;
+    const int SHORT_ROOK_COL = 0;
+    const int LONG_ROOK_COL = 7;
+
+    /**
+     * @brief Gets the back row of a side
+     */
+    int homeRow(const int& side) { return side == PLAYER_ONE ? 0 : 7; }
+
+    /**
+     * @brief Gets the castling rights that survive a move touching each square
+     */
+    struct CastlingMasks {
+        int keep[Bitboards::SQUARE_COUNT];
+
+        CastlingMasks() {
+            for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) { keep[sq] = 15; }
+            keep[Bitboards::square(0, KING_HOME_COL)] &= ~(1 | 2);
+            keep[Bitboards::square(0, SHORT_ROOK_COL)] &= ~1;
+            keep[Bitboards::square(0, LONG_ROOK_COL)] &= ~2;
+            keep[Bitboards::square(7, KING_HOME_COL)] &= ~(4 | 8);
+            keep[Bitboards::square(7, SHORT_ROOK_COL)] &= ~4;
+            keep[Bitboards::square(7, LONG_ROOK_COL)] &= ~8;
+        }
+    };
+    const CastlingMasks CASTLING_MASKS;
+}
+
+/**
+ * @brief Gets the piece kind for a ChessPiece, based on its type string
+ * @return NO_PIECE_KIND if the type is not one of the six chess pieces
+ */
+int ChessBoard::kindOf(const ChessPiece& piece) {
+    return piece.getKind();
+}
+
+/**
+ * @brief Allocates a ChessPiece of the given kind
+ */
+ChessPiece* ChessBoard::createPiece(const int& kind, const std::string& color, const int& row, const int& col, const bool& movingUp) {
+    switch (kind) {
+        case PAWN_KIND:   return new Pawn(color, row, col, movingUp);
+        case KNIGHT_KIND: return new Knight(color, row, col, movingUp);
+        case BISHOP_KIND: return new Bishop(color, row, col, movingUp);
+        case ROOK_KIND:   return new Rook(color, row, col, movingUp);
+        case QUEEN_KIND:  return new Queen(color, row, col, movingUp);
+        case KING_KIND:   return new King(color, row, col, movingUp);
+        default:          return nullptr;
+    }
+}
+
+/**
+ * @brief Rebuilds the bitboards, mailbox, attack maps and evaluation terms from a piece code per square
+ * @note Leaves the castling rights, en passant square, counters, Zobrist key and history to the caller
+ */
+void ChessBoard::loadPieceCodes(const uint8_t* codes) {
+    for (int side = 0; side < SIDE_COUNT; side++) {
+        sideBoards[side] = 0;
+        attackMaps[side] = 0;
+        for (int kind = 0; kind < PIECE_KIND_COUNT; kind++) { pieceBoards[side][kind] = 0; }
+    }
+    occupancy = 0;
+    zobristKey = 0;
+    middlegameScore = 0;
+    endgameScore = 0;
+    gamePhase = 0;
+
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        mailbox[sq] = PieceCodes::NO_PIECE;
+        squareAttacks[sq] = 0;
+        if (codes[sq] != PieceCodes::NO_PIECE) { putPiece(sq, codes[sq]); }
+    }
+
+    refreshAttacks(occupancy);
+}
+
+/**
+ * @brief Rebuilds the bitboards, mailbox, attack maps and castling rights from the pieces on `board`
+ * @post Castling rights are granted for every unmoved King on its home cell with an unmoved Rook in the corner.
+ *       There is no en passant square, and the move counters are reset.
+ */
+void ChessBoard::syncFromBoard() {
+    uint8_t codes[Bitboards::SQUARE_COUNT];
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        codes[sq] = PieceCodes::NO_PIECE;
+        ChessPiece* piece = board[Bitboards::rowOf(sq)][Bitboards::colOf(sq)];
+        if (!piece) { continue; }
+        int kind = kindOf(*piece);
+        if (kind == NO_PIECE_KIND) { continue; }
+        int side = (piece->getColor() == p1_color) ? PLAYER_ONE : PLAYER_TWO;
+        codes[sq] = PieceCodes::make(side, kind);
+    }
+    loadPieceCodes(codes);
+
+    // Castling needs an unmoved King on its home cell and an unmoved Rook of the same side in the corner
+    castlingRights = 0;
+    for (int side = 0; side < SIDE_COUNT; side++) {
+        int row = homeRow(side);
+        ChessPiece* king = board[row][KING_HOME_COL];
+        if (!king || mailbox[Bitboards::square(row, KING_HOME_COL)] != PieceCodes::make(side, KING_KIND) || king->hasMoved()) { continue; }
+
+        const int rookCols[2] = { SHORT_ROOK_COL, LONG_ROOK_COL };
+        for (int i = 0; i < 2; i++) {
+            ChessPiece* rook = board[row][rookCols[i]];
+            if (rook && mailbox[Bitboards::square(row, rookCols[i])] == PieceCodes::make(side, ROOK_KIND) && !rook->hasMoved()) {
+                castlingRights |= (1 << i) << (2 * side);
+            }
+        }
+    }
+
+    enPassantSquare = Bitboards::NO_SQUARE;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    zobristKey = computeHash();
+    history.clear();
+    history.reserve(256);
+}
+
+/**
+ * @brief Recomputes the Zobrist key from scratch, for verifying the incremental key returned by hash()
+ */
+uint64_t ChessBoard::computeHash() const {
+    uint64_t key = 0;
+    for (Bitboard remaining = occupancy; remaining; ) {
+        int sq = Bitboards::popLowest(remaining);
+        key ^= Zobrist::piece(mailbox[sq], sq);
+    }
+
+    key ^= Zobrist::castling(castlingRights);
+    if (enPassantSquare != Bitboards::NO_SQUARE) { key ^= Zobrist::enPassant(enPassantSquare); }
+    if (playerOneTurn) { key ^= Zobrist::playerOneKey; }
+    return key;
+}
+
+/**
+ * @brief Recomputes the evaluation from scratch, for verifying the incremental one returned by evaluate()
+ */
+int ChessBoard::computeEvaluation() const {
+    int middlegame = 0;
+    int endgame = 0;
+    int phase = 0;
+    for (Bitboard remaining = occupancy; remaining; ) {
+        int sq = Bitboards::popLowest(remaining);
+        middlegame += Evaluation::middlegame(mailbox[sq], sq);
+        endgame += Evaluation::endgame(mailbox[sq], sq);
+        phase += Evaluation::phase(mailbox[sq]);
+    }
+
+    int score = Evaluation::blend(middlegame, endgame, phase);
+    return playerOneTurn ? score : -score;
+}
+
+/**
+ * @brief Debug builds (EVAL_DEBUG) only: aborts if the incremental evaluation differs from a full recomputation
+ */
+void ChessBoard::verifyEvaluation() const {
+#ifdef EVAL_DEBUG
+    int incremental = evaluate();
+    int recomputed = computeEvaluation();
+    if (incremental != recomputed) {
+        std::fprintf(stderr, "ChessBoard: incremental evaluation %d != recomputed %d after %zu moves\n",
+                     incremental, recomputed, history.size());
+        std::abort();
+    }
+#endif
+}
+
+namespace {
+    const char FEN_PIECE_LETTERS[PIECE_KIND_COUNT + 1] = "pnbrqk";
+
+    /**
+     * @brief Gets the piece kind of a lowercase FEN letter, or NO_PIECE_KIND
+     */
+    int kindOfLetter(const char& letter) {
+        for (int kind = 0; kind < PIECE_KIND_COUNT; kind++) {
+            if (FEN_PIECE_LETTERS[kind] == letter) { return kind; }
+        }
+        return NO_PIECE_KIND;
+    }
+
+    /**
+     * @brief Reads an unsigned decimal field starting at `pos`
+     * @return False if there is no digit at `pos` or the value overflows `limit`
+     */
+    bool readCounter(std::string_view text, size_t& pos, const int& limit, int& value) {
+        if (pos >= text.size() || text[pos] < '0' || text[pos] > '9') { return false; }
+        value = 0;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            value = value * 10 + (text[pos++] - '0');
+            if (value > limit) { return false; }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Determines whether `side` attacks `sq`, given the position's bitboards
+     */
+    bool attackedIn(const Bitboard pieces[SIDE_COUNT][PIECE_KIND_COUNT], const Bitboard& occupied, const int& sq, const int& side) {
+        const Bitboard* own = pieces[side];
+        return (Attacks::pawn(side != PLAYER_ONE, sq) & own[PAWN_KIND]) ||
+               (Attacks::knight(sq) & own[KNIGHT_KIND]) ||
+               (Attacks::king(sq) & own[KING_KIND]) ||
+               (Attacks::rook(sq, occupied) & (own[ROOK_KIND] | own[QUEEN_KIND])) ||
+               (Attacks::bishop(sq, occupied) & (own[BISHOP_KIND] | own[QUEEN_KIND]));
+    }
+}
+
+/**
+ * @brief Sets up the position described by a FEN record, eg.
+ *        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1" for the default board.
+ *        Lowercase pieces belong to PLAYER_ONE (p1_color, rank 8 = row 0, moving up), uppercase to PLAYER_TWO;
+ *        "b" means it is player one's turn. Files run from column 7 ('a') down to column 0 ('h').
+ * @param fen Placement, side to move, castling rights and en passant square, optionally followed by
+ *        the halfmove clock and fullmove number (default 0 and 1). Fields are separated by spaces.
+ * @param error If not null, receives a description of the problem when the record is rejected
+ * @return True if the position was loaded. On false the board is left unchanged.
+ * @note The record is read in place, without copying or splitting it. Castling rights must match a King and Rook on
+ *       their home cells. An en passant square is kept only if a pawn can actually capture onto it.
+ *       The move history is cleared, and the ChessPieces already on the board are reused where possible, so
+ *       loading many positions into one board allocates next to nothing.
+ */
+bool ChessBoard::fromFEN(std::string_view fen, std::string* error) {
+    auto reject = [error](const char* message) {
+        if (error) { *error = message; }
+        return false;
+    };
+    size_t pos = 0;
+    auto skipSpaces = [&fen, &pos]() {
+        size_t start = pos;
+        while (pos < fen.size() && fen[pos] == ' ') { pos++; }
+        return pos > start;
+    };
+
+    // Everything is parsed and checked into locals first, so a rejected record leaves the board as it was
+    uint8_t codes[Bitboards::SQUARE_COUNT];
+    std::fill(codes, codes + Bitboards::SQUARE_COUNT, uint8_t(PieceCodes::NO_PIECE));
+
+    skipSpaces();
+    int row = 0;
+    int file = 0;
+    for (; pos < fen.size() && fen[pos] != ' '; pos++) {
+        char c = fen[pos];
+        if (c == '/') {
+            if (file != BOARD_LENGTH) { return reject("FEN: a rank does not describe exactly 8 squares"); }
+            if (++row >= BOARD_LENGTH) { return reject("FEN: more than 8 ranks"); }
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > BOARD_LENGTH) { return reject("FEN: a rank does not describe exactly 8 squares"); }
+        } else {
+            bool upper = (c >= 'A' && c <= 'Z');
+            int kind = kindOfLetter(upper ? char(c - 'A' + 'a') : c);
+            if (kind == NO_PIECE_KIND) { return reject("FEN: unknown piece letter"); }
+            if (file >= BOARD_LENGTH) { return reject("FEN: a rank does not describe exactly 8 squares"); }
+            int sq = Bitboards::square(row, BOARD_LENGTH - 1 - file);
+            codes[sq] = PieceCodes::make(upper ? PLAYER_TWO : PLAYER_ONE, kind);
+            file++;
+        }
+    }
+    if (row != BOARD_LENGTH - 1 || file != BOARD_LENGTH) { return reject("FEN: the placement does not describe 8 ranks"); }
+
+    if (!skipSpaces() || pos >= fen.size()) { return reject("FEN: missing side to move"); }
+    bool p1Turn = false;
+    if (fen[pos] == 'b') {
+        p1Turn = true;
+    } else if (fen[pos] != 'w') {
+        return reject("FEN: the side to move must be 'w' or 'b'");
+    }
+    pos++;
+
+    if (!skipSpaces() || pos >= fen.size()) { return reject("FEN: missing castling rights"); }
+    int rights = 0;
+    if (fen[pos] == '-') {
+        pos++;
+    } else {
+        for (; pos < fen.size() && fen[pos] != ' '; pos++) {
+            // K and Q are PLAYER_TWO's short (towards column 0, the h-file) and long castles; k and q are PLAYER_ONE's
+            int right = 0;
+            switch (fen[pos]) {
+                case 'K': right = PLAYER_TWO_SHORT_CASTLE; break;
+                case 'Q': right = PLAYER_TWO_LONG_CASTLE; break;
+                case 'k': right = PLAYER_ONE_SHORT_CASTLE; break;
+                case 'q': right = PLAYER_ONE_LONG_CASTLE; break;
+                default: return reject("FEN: castling rights must be '-' or letters from KQkq");
+            }
+            if (rights & right) { return reject("FEN: a castling right is repeated"); }
+            rights |= right;
+        }
+    }
+
+    if (!skipSpaces() || pos >= fen.size()) { return reject("FEN: missing en passant square"); }
+    int passed = Bitboards::NO_SQUARE;
+    if (fen[pos] == '-') {
+        pos++;
+    } else {
+        if (pos + 1 >= fen.size() || fen[pos] < 'a' || fen[pos] > 'h' || fen[pos + 1] < '1' || fen[pos + 1] > '8') {
+            return reject("FEN: malformed en passant square");
+        }
+        passed = Bitboards::square(7 - (fen[pos + 1] - '1'), 7 - (fen[pos] - 'a'));
+        pos += 2;
+    }
+
+    int halfmoves = 0;
+    int fullmoves = 1;
+    if (skipSpaces() && pos < fen.size()) {
+        if (!readCounter(fen, pos, 1 << 20, halfmoves)) { return reject("FEN: malformed halfmove clock"); }
+        if (skipSpaces() && pos < fen.size()) {
+            if (!readCounter(fen, pos, 1 << 20, fullmoves) || fullmoves < 1) { return reject("FEN: malformed fullmove number"); }
+            skipSpaces();
+        }
+    }
+    if (pos != fen.size()) { return reject("FEN: unexpected text after the last field"); }
+
+    if (!setPosition(codes, p1Turn, rights, passed, halfmoves, fullmoves, error)) {
+        if (error) { error->insert(0, "FEN: "); }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sets up a position from a piece code per square and the rest of the game state, checking it as fromFEN() does
+ * @param codes 64 piece codes (see engine/Types.hpp), PieceCodes::NO_PIECE on empty squares
+ * @param p1Turn Whether it is player one's turn
+ * @param rights Castling rights (see the *_CASTLE constants)
+ * @param passed The square skipped by the last double pawn push, or Bitboards::NO_SQUARE
+ * @param halfmoves Moves since the last capture or pawn move
+ * @param fullmoves Starts at 1 and is incremented after PLAYER_ONE moves
+ * @param error If not null, receives a description of the problem when the position is rejected
+ * @return True if the position was loaded. On false the board is left unchanged.
+ * @note Loads exactly like fromFEN() (kept en passant squares, cleared history, recycled pieces), minus the parsing
+ */
+bool ChessBoard::setPosition(const uint8_t* codes, const bool& p1Turn, const int& rights, const int& passed,
+                             const int& halfmoves, const int& fullmoves, std::string* error) {
+    auto reject = [error](const char* message) {
+        if (error) { *error = message; }
+        return false;
+    };
+
+    Bitboard pieces[SIDE_COUNT][PIECE_KIND_COUNT] = {};
+    Bitboard occupied = 0;
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        if (codes[sq] == PieceCodes::NO_PIECE) { continue; }
+        if (codes[sq] > PieceCodes::NO_PIECE) { return reject("unknown piece code"); }
+        pieces[PieceCodes::sideOf(codes[sq])][PieceCodes::kindOf(codes[sq])] |= Bitboards::squareBit(sq);
+        occupied |= Bitboards::squareBit(sq);
+    }
+
+    const Bitboard BACK_ROWS = 0xFF000000000000FFULL;
+    if ((pieces[PLAYER_ONE][PAWN_KIND] | pieces[PLAYER_TWO][PAWN_KIND]) & BACK_ROWS) {
+        return reject("a pawn stands on the first or last rank");
+    }
+    if (!pieces[PLAYER_ONE][KING_KIND] || !pieces[PLAYER_TWO][KING_KIND]) { return reject("a side has no King"); }
+    if (Bitboards::moreThanOne(pieces[PLAYER_ONE][KING_KIND]) || Bitboards::moreThanOne(pieces[PLAYER_TWO][KING_KIND])) {
+        return reject("a side has more than one King");
+    }
+    int us = p1Turn ? PLAYER_ONE : PLAYER_TWO;
+    if (attackedIn(pieces, occupied, Bitboards::lowestSquare(pieces[us ^ 1][KING_KIND]), us)) {
+        return reject("the side not to move is in check");
+    }
+
+    if (rights & ~ALL_CASTLING_RIGHTS) { return reject("unknown castling right"); }
+    for (int side = 0; side < SIDE_COUNT; side++) {
+        const int rookCols[2] = { SHORT_ROOK_COL, LONG_ROOK_COL };
+        for (int i = 0; i < 2; i++) {
+            if (!(rights & ((1 << i) << (2 * side)))) { continue; }
+            if (codes[Bitboards::square(homeRow(side), KING_HOME_COL)] != PieceCodes::make(side, KING_KIND) ||
+                codes[Bitboards::square(homeRow(side), rookCols[i])] != PieceCodes::make(side, ROOK_KIND)) {
+                return reject("a castling right has no King and Rook on their home cells");
+            }
+        }
+    }
+
+    if (passed != Bitboards::NO_SQUARE) {
+        // The square was just skipped by a pawn of the side that is not to move, which now stands right past it
+        int them = us ^ 1;
+        int expectedRow = (them == PLAYER_ONE) ? 2 : BOARD_LENGTH - 3;
+        if (passed < 0 || passed >= Bitboards::SQUARE_COUNT || Bitboards::rowOf(passed) != expectedRow ||
+            codes[passed] != PieceCodes::NO_PIECE ||
+            codes[(them == PLAYER_ONE) ? passed + 8 : passed - 8] != PieceCodes::make(them, PAWN_KIND)) {
+            return reject("the en passant square does not follow a double pawn push");
+        }
+    }
+    if (halfmoves < 0 || fullmoves < 1) { return reject("negative halfmove clock or fullmove number below 1"); }
+
+    // The record is valid: rebuild the pieces. Constructing ChessPieces dominates the cost of loading a position, so
+    // the pieces already on the board are recycled wherever a piece of the same side and kind is needed.
+    static const int DEFAULT_CASTLE_MOVES = Rook().getCastleMovesLeft();
+    ChessPiece* spare[PieceCodes::CODE_COUNT][Bitboards::SQUARE_COUNT];
+    int spareCount[PieceCodes::CODE_COUNT] = {};
+    for (Bitboard remaining = occupancy; remaining; ) {
+        int sq = Bitboards::popLowest(remaining);
+        ChessPiece*& cell = board[Bitboards::rowOf(sq)][Bitboards::colOf(sq)];
+        uint8_t code = mailbox[sq];
+
+        bool reusable = cell->isMovingUp() == (PieceCodes::sideOf(code) == PLAYER_ONE) &&
+                        (PieceCodes::kindOf(code) != ROOK_KIND ||
+                         static_cast<const Rook*>(cell)->getCastleMovesLeft() == DEFAULT_CASTLE_MOVES);
+        if (reusable) {
+            spare[code][spareCount[code]++] = cell;
+            cell = nullptr;
+        }
+    }
+    releasePieces();
+
+    // Only Kings and Rooks with castling rights count as unmoved, and pawns off their starting row have moved
+    for (Bitboard remaining = occupied; remaining; ) {
+        int sq = Bitboards::popLowest(remaining);
+        int side = PieceCodes::sideOf(codes[sq]);
+        int kind = PieceCodes::kindOf(codes[sq]);
+        int sqRow = Bitboards::rowOf(sq);
+        int sqCol = Bitboards::colOf(sq);
+
+        ChessPiece* piece = nullptr;
+        if (spareCount[codes[sq]] > 0) {
+            piece = spare[codes[sq]][--spareCount[codes[sq]]];
+            piece->setRow(sqRow);
+            piece->setColumn(sqCol);
+        } else {
+            piece = createPiece(kind, side == PLAYER_ONE ? p1_color : p2_color, sqRow, sqCol, side == PLAYER_ONE);
+        }
+
+        bool moved = false;
+        if (kind == PAWN_KIND) {
+            moved = sqRow != ((side == PLAYER_ONE) ? 1 : BOARD_LENGTH - 2);
+        } else if (kind == KING_KIND) {
+            moved = !(rights & ((PLAYER_ONE_SHORT_CASTLE | PLAYER_ONE_LONG_CASTLE) << (2 * side)));
+        } else if (kind == ROOK_KIND) {
+            moved = !((sqRow == homeRow(side) && sqCol == SHORT_ROOK_COL && (rights & (PLAYER_ONE_SHORT_CASTLE << (2 * side)))) ||
+                      (sqRow == homeRow(side) && sqCol == LONG_ROOK_COL && (rights & (PLAYER_ONE_LONG_CASTLE << (2 * side)))));
+        }
+        piece->setMoved(moved);
+        board[sqRow][sqCol] = piece;
+    }
+    for (int code = 0; code < PieceCodes::CODE_COUNT; code++) {
+        while (spareCount[code] > 0) { delete spare[code][--spareCount[code]]; }
+    }
+
+    playerOneTurn = p1Turn;
+    loadPieceCodes(codes);
+    castlingRights = rights;
+
+    // Only keep an en passant square that a pawn can capture onto, as makeMove() does
+    enPassantSquare = Bitboards::NO_SQUARE;
+    if (passed != Bitboards::NO_SQUARE && (Attacks::pawn(us != PLAYER_ONE, passed) & pieceBoards[us][PAWN_KIND])) {
+        enPassantSquare = passed;
+    }
+    halfmoveClock = halfmoves;
+    fullmoveNumber = fullmoves;
+
+    // loadPieceCodes() left the pieces' keys in zobristKey
+    zobristKey ^= Zobrist::castling(castlingRights);
+    if (enPassantSquare != Bitboards::NO_SQUARE) { zobristKey ^= Zobrist::enPassant(enPassantSquare); }
+    if (playerOneTurn) { zobristKey ^= Zobrist::playerOneKey; }
+    history.clear();
+    return true;
+}
+
+/**
+ * @brief Describes the position as a FEN record; fromFEN(toFEN()) reproduces it exactly
+ */
+std::string ChessBoard::toFEN() const {
+    // Longest record: 64 pieces + 7 slashes, then " w KQkq e3 " and two counters
+    char text[128];
+    char* out = text;
+
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        int empty = 0;
+        for (int col = BOARD_LENGTH - 1; col >= 0; col--) {
+            uint8_t code = mailbox[Bitboards::square(row, col)];
+            if (code == PieceCodes::NO_PIECE) {
+                empty++;
+                continue;
+            }
+            if (empty) { *out++ = char('0' + empty); }
+            empty = 0;
+            char letter = FEN_PIECE_LETTERS[PieceCodes::kindOf(code)];
+            *out++ = (PieceCodes::sideOf(code) == PLAYER_TWO) ? char(letter - 'a' + 'A') : letter;
+        }
+        if (empty) { *out++ = char('0' + empty); }
+        if (row < BOARD_LENGTH - 1) { *out++ = '/'; }
+    }
+
+    *out++ = ' ';
+    *out++ = playerOneTurn ? 'b' : 'w';
+    *out++ = ' ';
+    if (!castlingRights) { *out++ = '-'; }
+    if (castlingRights & PLAYER_TWO_SHORT_CASTLE) { *out++ = 'K'; }
+    if (castlingRights & PLAYER_TWO_LONG_CASTLE) { *out++ = 'Q'; }
+    if (castlingRights & PLAYER_ONE_SHORT_CASTLE) { *out++ = 'k'; }
+    if (castlingRights & PLAYER_ONE_LONG_CASTLE) { *out++ = 'q'; }
+    *out++ = ' ';
+    if (enPassantSquare == Bitboards::NO_SQUARE) {
+        *out++ = '-';
+    } else {
+        *out++ = char('a' + (7 - Bitboards::colOf(enPassantSquare)));
+        *out++ = char('1' + (7 - Bitboards::rowOf(enPassantSquare)));
+    }
+    out += std::snprintf(out, text + sizeof(text) - out, " %d %d", halfmoveClock, fullmoveNumber);
+    return std::string(text, out);
+}
+
+void ChessBoard::putPiece(const int& sq, const uint8_t& code) {
+    Bitboard bit = Bitboards::squareBit(sq);
+    pieceBoards[PieceCodes::sideOf(code)][PieceCodes::kindOf(code)] |= bit;
+    sideBoards[PieceCodes::sideOf(code)] |= bit;
+    occupancy |= bit;
+    mailbox[sq] = code;
+    zobristKey ^= Zobrist::piece(code, sq);
+    middlegameScore += Evaluation::middlegame(code, sq);
+    endgameScore += Evaluation::endgame(code, sq);
+    gamePhase += Evaluation::phase(code);
+}
+
+void ChessBoard::removePiece(const int& sq) {
+    Bitboard bit = Bitboards::squareBit(sq);
+    uint8_t code = mailbox[sq];
+    pieceBoards[PieceCodes::sideOf(code)][PieceCodes::kindOf(code)] ^= bit;
+    sideBoards[PieceCodes::sideOf(code)] ^= bit;
+    occupancy ^= bit;
+    mailbox[sq] = PieceCodes::NO_PIECE;
+    zobristKey ^= Zobrist::piece(code, sq);
+    middlegameScore -= Evaluation::middlegame(code, sq);
+    endgameScore -= Evaluation::endgame(code, sq);
+    gamePhase -= Evaluation::phase(code);
+}
+
+void ChessBoard::relocatePiece(const int& from, const int& to) {
+    Bitboard bits = Bitboards::squareBit(from) | Bitboards::squareBit(to);
+    uint8_t code = mailbox[from];
+    pieceBoards[PieceCodes::sideOf(code)][PieceCodes::kindOf(code)] ^= bits;
+    sideBoards[PieceCodes::sideOf(code)] ^= bits;
+    occupancy ^= bits;
+    mailbox[from] = PieceCodes::NO_PIECE;
+    mailbox[to] = code;
+    zobristKey ^= Zobrist::piece(code, from) ^ Zobrist::piece(code, to);
+    middlegameScore += Evaluation::middlegame(code, to) - Evaluation::middlegame(code, from);
+    endgameScore += Evaluation::endgame(code, to) - Evaluation::endgame(code, from);
+}
+
+/**
+ * @brief Moves the ChessPiece* at `from` on `board` to `to`, updating its row and column
+ */
+void ChessBoard::relocateBoardPiece(const int& from, const int& to) {
+    ChessPiece*& source = board[Bitboards::rowOf(from)][Bitboards::colOf(from)];
+    ChessPiece* piece = source;
+    source = nullptr;
+    board[Bitboards::rowOf(to)][Bitboards::colOf(to)] = piece;
+    piece->setRow(Bitboards::rowOf(to));
+    piece->setColumn(Bitboards::colOf(to));
+}
+
+/**
+ * @brief Gets the squares attacked by the piece on `sq` with the current occupancy
+ */
+Bitboard ChessBoard::attacksFrom(const int& sq) const {
+    uint8_t code = mailbox[sq];
+    switch (PieceCodes::kindOf(code)) {
+        case PAWN_KIND:   return Attacks::pawn(PieceCodes::sideOf(code) == PLAYER_ONE, sq);
+        case KNIGHT_KIND: return Attacks::knight(sq);
+        case BISHOP_KIND: return Attacks::bishop(sq, occupancy);
+        case ROOK_KIND:   return Attacks::rook(sq, occupancy);
+        case QUEEN_KIND:  return Attacks::queen(sq, occupancy);
+        default:          return Attacks::king(sq);
+    }
+}
+
+/**
+ * @brief Recomputes the attack sets that the changed squares may have affected, then the per-side attack maps
+ * @param changed The squares whose contents changed
+ * @note Only the pieces on the changed squares and the sliders whose rays reach them can have new attack sets.
+ *       A slider reaches a changed square exactly when the square "sees" the slider with the same occupancy,
+ *       so the affected sliders fall out of one reverse lookup per changed square.
+ */
+void ChessBoard::refreshAttacks(const Bitboard& changed) {
+    Bitboard straight = pieceBoards[PLAYER_ONE][ROOK_KIND] | pieceBoards[PLAYER_TWO][ROOK_KIND] |
+                        pieceBoards[PLAYER_ONE][QUEEN_KIND] | pieceBoards[PLAYER_TWO][QUEEN_KIND];
+    Bitboard diagonal = pieceBoards[PLAYER_ONE][BISHOP_KIND] | pieceBoards[PLAYER_TWO][BISHOP_KIND] |
+                        pieceBoards[PLAYER_ONE][QUEEN_KIND] | pieceBoards[PLAYER_TWO][QUEEN_KIND];
+
+    Bitboard affected = changed & occupancy;
+    for (Bitboard remaining = changed; remaining; ) {
+        int sq = Bitboards::popLowest(remaining);
+        squareAttacks[sq] = 0;
+        affected |= (Attacks::rook(sq, occupancy) & straight) | (Attacks::bishop(sq, occupancy) & diagonal);
+    }
+
+    for (Bitboard remaining = affected; remaining; ) {
+        int sq = Bitboards::popLowest(remaining);
+        squareAttacks[sq] = attacksFrom(sq);
+    }
+
+    for (int side = 0; side < SIDE_COUNT; side++) {
+        Bitboard map = 0;
+        for (Bitboard remaining = sideBoards[side]; remaining; ) {
+            map |= squareAttacks[Bitboards::popLowest(remaining)];
+        }
+        attackMaps[side] = map;
+    }
+}
+
+/**
+ * @brief Gets the square of the given side's King, or Bitboards::NO_SQUARE if it has none
+ */
+int ChessBoard::kingSquare(const int& side) const {
+    Bitboard kings = pieceBoards[side][KING_KIND];
+    return kings ? Bitboards::lowestSquare(kings) : Bitboards::NO_SQUARE;
+}
+
+/**
+ * @brief Gets the squares of every piece in `occupied` (of either side) that attacks `sq`, as if only the squares in `occupied` held pieces
+ */
+Bitboard ChessBoard::attackersOf(const int& sq, const Bitboard& occupied) const {
+    Bitboard straight = pieceBoards[PLAYER_ONE][ROOK_KIND] | pieceBoards[PLAYER_TWO][ROOK_KIND] |
+                        pieceBoards[PLAYER_ONE][QUEEN_KIND] | pieceBoards[PLAYER_TWO][QUEEN_KIND];
+    Bitboard diagonal = pieceBoards[PLAYER_ONE][BISHOP_KIND] | pieceBoards[PLAYER_TWO][BISHOP_KIND] |
+                        pieceBoards[PLAYER_ONE][QUEEN_KIND] | pieceBoards[PLAYER_TWO][QUEEN_KIND];
+
+    // A pawn of one side attacks `sq` exactly when a pawn of the other side on `sq` would attack it back
+    return ((Attacks::pawn(false, sq) & pieceBoards[PLAYER_ONE][PAWN_KIND]) |
+            (Attacks::pawn(true, sq) & pieceBoards[PLAYER_TWO][PAWN_KIND]) |
+            (Attacks::knight(sq) & (pieceBoards[PLAYER_ONE][KNIGHT_KIND] | pieceBoards[PLAYER_TWO][KNIGHT_KIND])) |
+            (Attacks::king(sq) & (pieceBoards[PLAYER_ONE][KING_KIND] | pieceBoards[PLAYER_TWO][KING_KIND])) |
+            (Attacks::rook(sq, occupied) & straight) |
+            (Attacks::bishop(sq, occupied) & diagonal)) & occupied;
+}
+
+/**
+ * @brief Gets the enemy pieces currently giving check to the side to move
+ */
+Bitboard ChessBoard::checkers() const {
+    int us = sideToMove();
+    int king = kingSquare(us);
+    if (king == Bitboards::NO_SQUARE) { return 0; }
+    return attackersOf(king) & sideBoards[us ^ 1];
+}
+
+/**
+ * @brief Appends a pawn move, expanding it into the four promotions when it reaches the last row
+ */
+void ChessBoard::addPawnMove(MoveList& moves, const int& from, const int& to, const bool& capture) {
+    int row = Bitboards::rowOf(to);
+    if (row == 0 || row == BOARD_LENGTH - 1) {
+        for (int kind = QUEEN_KIND; kind >= KNIGHT_KIND; kind--) {
+            moves.push_back(Move(from, to, Move::promotionFlag(kind, capture)));
+        }
+        return;
+    }
+    moves.push_back(Move(from, to, capture ? Move::CAPTURE : Move::QUIET));
+}
+
+/**
+ * @brief Determines whether an en passant capture leaves the mover's King safe
+ * @note Two pawns leave the same row at once, so this is checked by replaying the occupancy rather than with pin rays
+ */
+bool ChessBoard::isEnPassantLegal(const int& from, const int& to) const {
+    int us = sideToMove();
+    int them = us ^ 1;
+    int king = kingSquare(us);
+    int captureSquare = (us == PLAYER_ONE) ? to - 8 : to + 8;
+
+    Bitboard after = (occupancy ^ Bitboards::squareBit(from) ^ Bitboards::squareBit(captureSquare)) | Bitboards::squareBit(to);
+    Bitboard queens = pieceBoards[them][QUEEN_KIND];
+
+    return !((Attacks::rook(king, after) & (pieceBoards[them][ROOK_KIND] | queens)) ||
+             (Attacks::bishop(king, after) & (pieceBoards[them][BISHOP_KIND] | queens)) ||
+             (Attacks::knight(king) & pieceBoards[them][KNIGHT_KIND]) ||
+             (Attacks::pawn(us == PLAYER_ONE, king) & pieceBoards[them][PAWN_KIND] & ~Bitboards::squareBit(captureSquare)));
+}
+
+/**
+ * @brief Generates every strictly legal move for the side to move
+ *
+ * Pin rays and the check mask are computed once per call, so pinned pieces only slide along their pin,
+ * and when in check only captures of the checker, blocks and King moves are produced. No move is ever
+ * made and tested afterwards.
+ *
+ * @param moves The list the moves are appended to. It is cleared first.
+ */
+void ChessBoard::generateLegalMoves(MoveList& moves) const {
+    moves.clear();
+
+    int us = sideToMove();
+    int them = us ^ 1;
+    int king = kingSquare(us);
+    if (king == Bitboards::NO_SQUARE) { return; }
+
+    Bitboard own = sideBoards[us];
+    Bitboard enemy = sideBoards[them];
+    Bitboard enemyStraight = pieceBoards[them][ROOK_KIND] | pieceBoards[them][QUEEN_KIND];
+    Bitboard enemyDiagonal = pieceBoards[them][BISHOP_KIND] | pieceBoards[them][QUEEN_KIND];
+    Bitboard checking = attackersOf(king) & enemy;
+
+    // King moves. The attack map already covers defended pieces; the only squares it misses are the ones
+    // behind the King on a checking slider's ray, which the King would stop shielding once it steps away.
+    Bitboard kingTargets = Attacks::king(king) & ~own & ~attackMaps[them];
+    for (Bitboard sliders = checking & (enemyStraight | enemyDiagonal); sliders; ) {
+        int slider = Bitboards::popLowest(sliders);
+        kingTargets &= ~(Attacks::line(slider, king) ^ Bitboards::squareBit(slider));
+    }
+    while (kingTargets) {
+        int to = Bitboards::popLowest(kingTargets);
+        moves.push_back(Move(king, to, (enemy & Bitboards::squareBit(to)) ? Move::CAPTURE : Move::QUIET));
+    }
+
+    // In double check only the King can move
+    if (Bitboards::moreThanOne(checking)) { return; }
+
+    // Every other move has to capture the checker or land between it and the King
+    Bitboard checkMask = ~Bitboard(0);
+    if (checking) { checkMask = checking | Attacks::between(king, Bitboards::lowestSquare(checking)); }
+
+    // A piece is pinned when it is the only piece between the King and an enemy slider lined up with it
+    Bitboard pinned = 0;
+    Bitboard snipers = (Attacks::rook(king, 0) & enemyStraight) | (Attacks::bishop(king, 0) & enemyDiagonal);
+    while (snipers) {
+        Bitboard blockers = Attacks::between(king, Bitboards::popLowest(snipers)) & occupancy;
+        if (blockers && !Bitboards::moreThanOne(blockers)) { pinned |= blockers & own; }
+    }
+
+    // Pawns
+    bool movingUp = (us == PLAYER_ONE);
+    int forward = movingUp ? 8 : -8;
+    int startRow = movingUp ? 1 : BOARD_LENGTH - 2;
+    for (Bitboard pawns = pieceBoards[us][PAWN_KIND]; pawns; ) {
+        int from = Bitboards::popLowest(pawns);
+        Bitboard allowed = checkMask;
+        if (pinned & Bitboards::squareBit(from)) { allowed &= Attacks::line(king, from); }
+
+        int oneStep = from + forward;
+        if (!(occupancy & Bitboards::squareBit(oneStep))) {
+            if (allowed & Bitboards::squareBit(oneStep)) { addPawnMove(moves, from, oneStep, false); }
+
+            int twoStep = oneStep + forward;
+            if (Bitboards::rowOf(from) == startRow && !(occupancy & Bitboards::squareBit(twoStep)) && (allowed & Bitboards::squareBit(twoStep))) {
+                moves.push_back(Move(from, twoStep, Move::DOUBLE_PUSH));
+            }
+        }
+
+        Bitboard captures = Attacks::pawn(movingUp, from) & enemy & allowed;
+        while (captures) { addPawnMove(moves, from, Bitboards::popLowest(captures), true); }
+
+        if (enPassantSquare != Bitboards::NO_SQUARE && (Attacks::pawn(movingUp, from) & Bitboards::squareBit(enPassantSquare)) &&
+            isEnPassantLegal(from, enPassantSquare)) {
+            moves.push_back(Move(from, enPassantSquare, Move::EN_PASSANT));
+        }
+    }
+
+    // Knights, Bishops, Rooks and Queens
+    for (int kind = KNIGHT_KIND; kind <= QUEEN_KIND; kind++) {
+        for (Bitboard pieces = pieceBoards[us][kind]; pieces; ) {
+            int from = Bitboards::popLowest(pieces);
+            Bitboard targets = squareAttacks[from] & ~own & checkMask;
+            if (pinned & Bitboards::squareBit(from)) { targets &= Attacks::line(king, from); }
+
+            while (targets) {
+                int to = Bitboards::popLowest(targets);
+                moves.push_back(Move(from, to, (enemy & Bitboards::squareBit(to)) ? Move::CAPTURE : Move::QUIET));
+            }
+        }
+    }
+
+    // Castling: the King may not start in, pass through or land on an attacked cell
+    if (checking) { return; }
+    int row = homeRow(us);
+    int shortRight = (us == PLAYER_ONE) ? PLAYER_ONE_SHORT_CASTLE : PLAYER_TWO_SHORT_CASTLE;
+    int longRight = (us == PLAYER_ONE) ? PLAYER_ONE_LONG_CASTLE : PLAYER_TWO_LONG_CASTLE;
+
+    if (castlingRights & shortRight) {
+        Bitboard path = Bitboards::squareBit(Bitboards::square(row, 1)) | Bitboards::squareBit(Bitboards::square(row, 2));
+        if (!(occupancy & path) && !(attackMaps[them] & path)) {
+            moves.push_back(Move(king, Bitboards::square(row, 1), Move::SHORT_CASTLE));
+        }
+    }
+    if (castlingRights & longRight) {
+        Bitboard path = Bitboards::squareBit(Bitboards::square(row, 4)) | Bitboards::squareBit(Bitboards::square(row, 5));
+        Bitboard empty = path | Bitboards::squareBit(Bitboards::square(row, 6));
+        if (!(occupancy & empty) && !(attackMaps[them] & path)) {
+            moves.push_back(Move(king, Bitboards::square(row, 5), Move::LONG_CASTLE));
+        }
+    }
+}
+
+/**
+ * @brief Determines whether the side to move is in check
+ */
+bool ChessBoard::isCheck() const {
+    int us = sideToMove();
+    int king = kingSquare(us);
+    return king != Bitboards::NO_SQUARE && isAttacked(king, us ^ 1);
+}
+
+/**
+ * @brief Determines whether the side to move is in check and has no legal move
+ */
+bool ChessBoard::isCheckmate() const {
+    if (!isCheck()) { return false; }
+    MoveList moves;
+    generateLegalMoves(moves);
+    return moves.empty();
+}
+
+/**
+ * @brief Determines whether the side to move is not in check but has no legal move
+ */
+bool ChessBoard::isStalemate() const {
+    if (isCheck()) { return false; }
+    MoveList moves;
+    generateLegalMoves(moves);
+    return moves.empty();
+}
+
+/**
+ * @brief Determines whether the current position already occurred since the last irreversible move
+ * @note Uses the Zobrist keys saved in the move history, so only positions reached with makeMove() are seen
+ */
+bool ChessBoard::isRepetition() const {
+    // Positions with the same side to move are two plies apart, and none can predate the last capture or pawn move
+    int oldest = std::max(0, int(history.size()) - halfmoveClock);
+    for (int i = int(history.size()) - 2; i >= oldest; i -= 2) {
+        if (history[i].key == zobristKey) { return true; }
+    }
+    return false;
+}
+
+/**
+ * @brief Determines whether the position is drawn by repetition or by the fifty-move rule
+ */
+bool ChessBoard::isDraw() const {
+    return halfmoveClock >= 100 || isRepetition();
+}
+
+/**
+ * @brief Counts the leaf nodes of the legal move tree to the given depth (performance test)
+ * @param depth The number of plies to expand. perft(0) is 1.
+ * @note The last ply is counted from the size of the move list rather than played out ("bulk counting").
+ *       The board is left exactly as it was.
+ */
+uint64_t ChessBoard::perft(const int& depth) {
+    if (depth <= 0) { return 1; }
+
+    MoveList moves;
+    generateLegalMoves(moves);
+    if (depth == 1) { return uint64_t(moves.size()); }
+
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        makeMove(move);
+        nodes += perft(depth - 1);
+        unmakeMove();
+    }
+    return nodes;
+}
+
+/**
+ * @brief Runs perft(depth - 1) below each legal move, for finding which move a wrong count comes from
+ * @param depth The total depth, including the root move. Must be at least 1.
+ * @return Each root move paired with its subtree count, in generation order
+ */
+std::vector<std::pair<Move, uint64_t>> ChessBoard::perftDivide(const int& depth) {
+    std::vector<std::pair<Move, uint64_t>> counts;
+
+    MoveList moves;
+    generateLegalMoves(moves);
+    for (const Move& move : moves) {
+        makeMove(move);
+        counts.push_back(std::make_pair(move, perft(depth - 1)));
+        unmakeMove();
+    }
+    return counts;
+}
+
+/**
+ * @brief Plays a move for the side to move
+ * @pre The move is pseudo-legal in the current position
+ * @post `board`, the bitboards, the attack maps and the position state all reflect the move. Captured pieces
+ *       are taken off the board (row and column -1) but stay allocated until the move is unmade or the board is destroyed.
+ *       A promotion allocates the new piece and parks the pawn the same way.
+ */
+void ChessBoard::makeMove(const Move& move) {
+    int us = sideToMove();
+    int from = move.from();
+    int to = move.to();
+    int flag = move.flag();
+    uint8_t moving = mailbox[from];
+    ChessPiece* mover = board[Bitboards::rowOf(from)][Bitboards::colOf(from)];
+
+    UndoRecord undo;
+    undo.move = move;
+    undo.key = zobristKey;
+    undo.captured = PieceCodes::NO_PIECE;
+    undo.castlingRights = uint8_t(castlingRights);
+    undo.enPassantSquare = int8_t(enPassantSquare);
+    undo.halfmoveClock = halfmoveClock;
+    undo.moverHadMoved = mover->hasMoved();
+    undo.rookHadMoved = false;
+    undo.capturedPiece = nullptr;
+    undo.promotedPawn = nullptr;
+
+    Bitboard changed = Bitboards::squareBit(from) | Bitboards::squareBit(to);
+
+    if (move.isCapture()) {
+        // An en passant capture takes the pawn that just moved past `to`, one row behind it
+        int captureSquare = (flag == Move::EN_PASSANT) ? (us == PLAYER_ONE ? to - 8 : to + 8) : to;
+        undo.captured = mailbox[captureSquare];
+        removePiece(captureSquare);
+
+        ChessPiece*& cell = board[Bitboards::rowOf(captureSquare)][Bitboards::colOf(captureSquare)];
+        undo.capturedPiece = cell;
+        cell->setRow(-1);
+        cell = nullptr;
+        changed |= Bitboards::squareBit(captureSquare);
+    }
+
+    relocatePiece(from, to);
+    relocateBoardPiece(from, to);
+    mover->flagMoved();
+
+    if (move.isPromotion()) {
+        removePiece(to);
+        putPiece(to, PieceCodes::make(us, move.promotionKind()));
+
+        ChessPiece* promoted = createPiece(move.promotionKind(), mover->getColor(), Bitboards::rowOf(to), Bitboards::colOf(to), mover->isMovingUp());
+        promoted->flagMoved();
+        board[Bitboards::rowOf(to)][Bitboards::colOf(to)] = promoted;
+        mover->setRow(-1);
+        undo.promotedPawn = mover;
+    } else if (move.isCastle()) {
+        int row = Bitboards::rowOf(from);
+        int rookFrom = Bitboards::square(row, flag == Move::SHORT_CASTLE ? SHORT_ROOK_COL : LONG_ROOK_COL);
+        int rookTo = (from + to) / 2;  // The Rook lands on the cell the King passed over
+        ChessPiece* rook = board[row][Bitboards::colOf(rookFrom)];
+        undo.rookHadMoved = rook->hasMoved();
+
+        relocatePiece(rookFrom, rookTo);
+        relocateBoardPiece(rookFrom, rookTo);
+        rook->flagMoved();
+        changed |= Bitboards::squareBit(rookFrom) | Bitboards::squareBit(rookTo);
+    }
+
+    // Take the old rights, en passant column and side out of the key; the new ones go back in below
+    zobristKey ^= Zobrist::castling(castlingRights) ^ Zobrist::playerOneKey;
+    if (enPassantSquare != Bitboards::NO_SQUARE) { zobristKey ^= Zobrist::enPassant(enPassantSquare); }
+
+    // En passant is only recorded when an enemy pawn is actually in position to take it
+    enPassantSquare = Bitboards::NO_SQUARE;
+    if (flag == Move::DOUBLE_PUSH) {
+        int passed = (from + to) / 2;
+        if (Attacks::pawn(us == PLAYER_ONE, passed) & pieceBoards[us ^ 1][PAWN_KIND]) { enPassantSquare = passed; }
+    }
+
+    castlingRights &= CASTLING_MASKS.keep[from] & CASTLING_MASKS.keep[to];
+    halfmoveClock = (move.isCapture() || PieceCodes::kindOf(moving) == PAWN_KIND) ? 0 : halfmoveClock + 1;
+    if (us == PLAYER_ONE) { fullmoveNumber++; }
+    playerOneTurn = !playerOneTurn;
+
+    zobristKey ^= Zobrist::castling(castlingRights);
+    if (enPassantSquare != Bitboards::NO_SQUARE) { zobristKey ^= Zobrist::enPassant(enPassantSquare); }
+
+    history.push_back(undo);
+    refreshAttacks(changed);
+    verifyEvaluation();
+}
+
+/**
+ * @brief Takes back the last move played with makeMove()
+ * @pre At least one move has been made
+ */
+void ChessBoard::unmakeMove() {
+    const UndoRecord undo = history.back();
+    history.pop_back();
+
+    playerOneTurn = !playerOneTurn;
+    int us = sideToMove();
+    int from = undo.move.from();
+    int to = undo.move.to();
+    int flag = undo.move.flag();
+    Bitboard changed = Bitboards::squareBit(from) | Bitboards::squareBit(to);
+
+    if (undo.move.isPromotion()) {
+        // Swap the promoted piece back out for the pawn that was parked in the undo record
+        removePiece(to);
+        putPiece(to, PieceCodes::make(us, PAWN_KIND));
+
+        ChessPiece*& cell = board[Bitboards::rowOf(to)][Bitboards::colOf(to)];
+        delete cell;
+        cell = undo.promotedPawn;
+    } else if (undo.move.isCastle()) {
+        int row = Bitboards::rowOf(from);
+        int rookFrom = Bitboards::square(row, flag == Move::SHORT_CASTLE ? SHORT_ROOK_COL : LONG_ROOK_COL);
+        int rookTo = (from + to) / 2;
+
+        relocatePiece(rookTo, rookFrom);
+        relocateBoardPiece(rookTo, rookFrom);
+        board[row][Bitboards::colOf(rookFrom)]->setMoved(undo.rookHadMoved);
+        changed |= Bitboards::squareBit(rookFrom) | Bitboards::squareBit(rookTo);
+    }
+
+    relocatePiece(to, from);
+    relocateBoardPiece(to, from);
+    board[Bitboards::rowOf(from)][Bitboards::colOf(from)]->setMoved(undo.moverHadMoved);
+
+    if (undo.captured != PieceCodes::NO_PIECE) {
+        int captureSquare = (flag == Move::EN_PASSANT) ? (us == PLAYER_ONE ? to - 8 : to + 8) : to;
+        putPiece(captureSquare, undo.captured);
+
+        ChessPiece* piece = undo.capturedPiece;
+        piece->setRow(Bitboards::rowOf(captureSquare));
+        piece->setColumn(Bitboards::colOf(captureSquare));
+        board[Bitboards::rowOf(captureSquare)][Bitboards::colOf(captureSquare)] = piece;
+        changed |= Bitboards::squareBit(captureSquare);
+    }
+
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    halfmoveClock = undo.halfmoveClock;
+    zobristKey = undo.key;
+    if (us == PLAYER_ONE) { fullmoveNumber--; }
+
+    refreshAttacks(changed);
+    verifyEvaluation();
 }
 
 // MY CODE BELOW
 
 // Alias for readability
 typedef std::vector<std::vector<char>> CharacterBoard;
+typedef ChessBoard::FlatCharacterBoard FlatCharacterBoard;
 
 /**
 * @brief A STATIC helper function for recursively solving the 8-queens problem.
@@ -120,47 +1248,53 @@ typedef std::vector<std::vector<char>> CharacterBoard;
 * @param board A (non-const) reference to a 2D vector of ChessPiece*, representing the current board configuration
 * @param placedQueens A (non-const) reference to a vector storing Queen*, which represents the queens we've placed so far
 * @param allBoards A (non-const) reference to a vector of CharacterBoard objects storing all the solutions we've found thus far
+* @param token If not null, polled at every node; once it is raised the search unwinds (freeing its queens)
+* @return False if the token stopped the search before every placement was tried
 */
-void ChessBoard::queenHelper(const int& col, std::vector<std::vector<ChessPiece*>>& board, std::vector<Queen*>& placedQueens, std::vector<CharacterBoard>& allBoards) {
+bool ChessBoard::queenHelper(const int& col, std::vector<std::vector<ChessPiece*>>& board, std::vector<Queen*>& placedQueens, std::vector<CharacterBoard>& allBoards,
+                             const CancellationToken* token) {
+    INSTRUMENT_COUNT(SOLVER_NODES);
+    if (token && token->stopRequested()) { return false; }
+
     // Base case: all 8 queens are placed 
-    if (col == 8) {
+    if (col == BOARD_LENGTH) {
         // Convert board into a CharacterBoard
-        CharacterBoard convertBoard(8, std::vector<char>(8, '*'));
-        for (int r = 0; r < 8; r++) {
-            for (int c = 0; c < 8; c++) {
+        CharacterBoard convertBoard(BOARD_LENGTH, std::vector<char>(BOARD_LENGTH, '*'));
+        for (int r = 0; r < BOARD_LENGTH; r++) {
+            for (int c = 0; c < BOARD_LENGTH; c++) {
                 if (board[r][c] != nullptr && board[r][c]->getType() == "QUEEN") {
                     convertBoard[r][c] = 'Q';
                 }
             }
         }
         allBoards.push_back(convertBoard);
-        return;
+        return true;
+    }
+
+    // Every cell the placed queens can move to, one pass per queen
+    Bitboard attacked = 0;
+    for (size_t i = 0; i < placedQueens.size(); ++i) {
+        attacked |= PieceRules::queenSquares(*placedQueens[i], board);
     }
 
     // Try placing a Queen in each row of the current column 
-    for (int row = 0; row < 8; row++) {
-        bool safe = true;
-        // Check if any of the placed queens can move to (row, col)
-        for (size_t i = 0; i < placedQueens.size(); ++i) {
-            Queen* queen = placedQueens[i]; 
-            if (queen->canMove(row, col, board)) {
-                safe = false;
-                break;
-            }
-        }
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        bool safe = (attacked & Bitboards::squareBit(Bitboards::square(row, col))) == 0;
 
         // If safe, place a queen and recurse
         if (safe) {
             Queen* newQueen = new Queen("WHITE", row, col, false);
             board[row][col] = newQueen;
             placedQueens.push_back(newQueen);
-            queenHelper(col + 1, board, placedQueens, allBoards);
+            bool finished = queenHelper(col + 1, board, placedQueens, allBoards, token);
             placedQueens.pop_back();
             //Deallocate the queen and remove it from the board
             delete board[row][col];
             board[row][col] = nullptr;
+            if (!finished) { return false; }
         }
     }
+    return true;
 }
 
 /** 
@@ -171,8 +1305,10 @@ void ChessBoard::queenHelper(const int& col, std::vector<std::vector<ChessPiece*
 *         to the 8-queens problem.
 */
 std::vector<CharacterBoard> ChessBoard::findAllQueenPlacements() {
+    INSTRUMENT_SCOPE(QUEEN_PLACEMENTS);
+
     // Initialize board, placedQueens, and allBoards
-    std::vector<std::vector<ChessPiece*>> board(8, std::vector<ChessPiece*>(8, nullptr));
+    std::vector<std::vector<ChessPiece*>> board(BOARD_LENGTH, std::vector<ChessPiece*>(BOARD_LENGTH, nullptr));
     std::vector<Queen*> placedQueens;
     std::vector<CharacterBoard> allBoards;
 
@@ -183,8 +1319,170 @@ std::vector<CharacterBoard> ChessBoard::findAllQueenPlacements() {
     return allBoards;
 }
 
+/** 
+* @brief Finds all solutions to the 8-queens problem, stopping early if the token is raised
+* 
+* @param token Polled at every node of the search
+* @param solutions Receives the solutions, or the ones found before the token was raised
+* @return True if the search finished, false if the token stopped it
+*/
+bool ChessBoard::findAllQueenPlacements(const CancellationToken& token, std::vector<CharacterBoard>& solutions) {
+    INSTRUMENT_SCOPE(QUEEN_PLACEMENTS);
+
+    std::vector<std::vector<ChessPiece*>> board(BOARD_LENGTH, std::vector<ChessPiece*>(BOARD_LENGTH, nullptr));
+    std::vector<Queen*> placedQueens;
+    solutions.clear();
+    return queenHelper(0, board, placedQueens, solutions, &token);
+}
+
+/** 
+* @brief Finds all solutions to the 8-queens problem as flat boards
+* 
+* @return The same solutions as findAllQueenPlacements(), in the same order
+*/
+std::vector<FlatCharacterBoard> ChessBoard::findAllFlatQueenPlacements() {
+    INSTRUMENT_SCOPE(QUEEN_PLACEMENTS);
+    return QueenSolver<BOARD_LENGTH>::findAllFlat();
+}
+
+/** 
+* @brief Finds all solutions to the 8-queens problem as flat boards, stopping early if the token is raised
+* 
+* @param solutions Receives the solutions, or the ones found before the token was raised
+* @return True if the search finished, false if the token stopped it
+*/
+bool ChessBoard::findAllFlatQueenPlacements(const CancellationToken& token, std::vector<FlatCharacterBoard>& solutions) {
+    INSTRUMENT_SCOPE(QUEEN_PLACEMENTS);
+    return QueenSolver<BOARD_LENGTH>::findAllFlat(token, solutions);
+}
+
+/** 
+* @brief Finds one placement of n non-attacking queens on an n x n board, for n up to the millions
+* 
+* @param n The board size
+* @param seed Seeds the random choices; each seed gives one fixed placement
+* @return The row of the queen in each column, or an empty vector if there is no placement (n = 2 or 3)
+*/
+std::vector<uint32_t> ChessBoard::findOneQueenPlacement(const int& n, const uint64_t& seed) {
+    std::vector<uint32_t> rows;
+    findOneQueenPlacement(n, CancellationToken(), rows, seed);
+    return rows;
+}
+
+/** 
+* @brief Finds one placement of n non-attacking queens, stopping early if the token is raised
+* 
+* @param token Polled between repair passes
+* @param rows Receives the row of the queen in each column, or is left empty if no placement was found
+* @return True if a placement was found, false if there is none or the token stopped the search
+* @note The queens always form a permutation (one per row and per column), so only diagonal attacks are counted.
+*       A diagonal holding k queens adds k - 1 attacks; the placement is valid once the total reaches 0.
+*/
+bool ChessBoard::findOneQueenPlacement(const int& n, const CancellationToken& token, std::vector<uint32_t>& rows, const uint64_t& seed) {
+    INSTRUMENT_SCOPE(QUEEN_PLACEMENTS);
+
+    const int GREEDY_ATTEMPTS = 32;   // Random free rows tried per column before settling for any free row
+    const int REPAIR_CANDIDATES = 16; // Random partners an attacked queen compares before swapping with the best
+    const int STALLED_PASSES = 64;    // Passes without progress before starting over from a new greedy placement
+
+    rows.clear();
+    if (n < 1 || n == 2 || n == 3) { return false; }
+
+    std::vector<int32_t> rising(2 * size_t(n) - 1);  // Queens on each row + col diagonal
+    std::vector<int32_t> falling(2 * size_t(n) - 1); // Queens on each row - col + n - 1 diagonal
+    Prng random(seed);
+    int64_t attacks = 0;
+
+    // Each returns the change in attacks
+    auto lift = [&](const uint32_t& row, const uint32_t& col) {
+        int change = 0;
+        if (--rising[row + col] > 0) { change--; }
+        if (--falling[row + n - 1 - col] > 0) { change--; }
+        return change;
+    };
+    auto drop = [&](const uint32_t& row, const uint32_t& col) {
+        int change = 0;
+        if (rising[row + col]++ > 0) { change++; }
+        if (falling[row + n - 1 - col]++ > 0) { change++; }
+        return change;
+    };
+    auto swapRows = [&](const uint32_t& a, const uint32_t& b) {
+        int change = lift(rows[a], a) + lift(rows[b], b);
+        std::swap(rows[a], rows[b]);
+        return change + drop(rows[a], a) + drop(rows[b], b);
+    };
+    auto attacked = [&](const uint32_t& col) {
+        return rising[rows[col] + col] > 1 || falling[rows[col] + n - 1 - col] > 1;
+    };
+
+    std::vector<uint32_t> pending;
+    std::vector<uint32_t> next;
+    while (true) {
+        // Greedy start: each column takes a random unused row that no earlier queen attacks, if one turns up quickly
+        rows.resize(n);
+        for (int i = 0; i < n; i++) { rows[i] = uint32_t(i); }
+        std::fill(rising.begin(), rising.end(), 0);
+        std::fill(falling.begin(), falling.end(), 0);
+        attacks = 0;
+        for (uint32_t col = 0; col < uint32_t(n); col++) {
+            uint32_t unused = uint32_t(n) - col;
+            uint32_t pick = col + uint32_t(random.next() % unused);
+            for (int attempt = 1; attempt < GREEDY_ATTEMPTS && (rising[rows[pick] + col] || falling[rows[pick] + n - 1 - col]); attempt++) {
+                pick = col + uint32_t(random.next() % unused);
+            }
+            std::swap(rows[col], rows[pick]);
+            attacks += drop(rows[col], col);
+        }
+
+        // Min-conflicts repair, one pass over the attacked queens at a time. Only the first pass scans the board: a
+        // queen only comes under attack when another moves onto its diagonal, and moved queens join the next pass
+        pending.clear();
+        for (uint32_t col = 0; col < uint32_t(n); col++) {
+            if (attacked(col)) { pending.push_back(col); }
+        }
+        int stalled = 0;
+        while (attacks > 0 && stalled < STALLED_PASSES) {
+            if (token.stopRequested()) {
+                rows.clear();
+                return false;
+            }
+            int64_t before = attacks;
+            next.clear();
+            for (const uint32_t& col : pending) {
+                if (!attacked(col)) { continue; }
+                uint32_t best = col;
+                int bestChange = 0;
+                for (int candidate = 0; candidate < REPAIR_CANDIDATES; candidate++) {
+                    uint32_t partner = uint32_t(random.next() % uint32_t(n));
+                    if (partner == col) { continue; }
+                    int change = swapRows(col, partner);
+                    swapRows(col, partner);
+                    if (change < bestChange) {
+                        bestChange = change;
+                        best = partner;
+                    }
+                }
+                if (best != col) {
+                    attacks += swapRows(col, best);
+                    next.push_back(best);
+                }
+                next.push_back(col);
+            }
+            pending.clear();
+            for (const uint32_t& col : next) {
+                if (attacked(col)) { pending.push_back(col); }
+            }
+            std::sort(pending.begin(), pending.end());
+            pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+            stalled = attacks < before ? 0 : stalled + 1;
+        }
+        if (attacks == 0) { return true; }
+    }
+}
+
 // Helper function to generate all transformations of a given board
 std::vector<CharacterBoard> ChessBoard::getAllTransformations(const CharacterBoard& board) {
+    INSTRUMENT_SCOPE(TRANSFORMATIONS);
     std::vector<CharacterBoard> transformations;
 
     // Generate all rotations
@@ -208,6 +1506,31 @@ std::vector<CharacterBoard> ChessBoard::getAllTransformations(const CharacterBoa
 
 // Helper function to compare two boards for equality
 bool ChessBoard::areBoardsEqual(const CharacterBoard& board1, const CharacterBoard& board2) {
+    INSTRUMENT_COUNT(GROUPING_COMPARISONS);
+    return board1 == board2;
+}
+
+// Helper function to generate the eight distinct transformations of a flat board
+std::array<FlatCharacterBoard, 8> ChessBoard::getAllTransformations(const FlatCharacterBoard& board) {
+    INSTRUMENT_SCOPE(TRANSFORMATIONS);
+    std::array<FlatCharacterBoard, 8> transformations;
+
+    // The four rotations, then each one flipped. Flipping across the horizontal axis as well would only repeat
+    // these: it is a flip across the vertical axis of the board rotated by 180 degrees.
+    transformations[0] = board;
+    for (int i = 1; i < 4; i++) {
+        transformations[i] = Transform::rotate(transformations[i - 1]);
+    }
+    for (int i = 0; i < 4; i++) {
+        transformations[4 + i] = Transform::flipAcrossVertical(transformations[i]);
+    }
+
+    return transformations;
+}
+
+// Helper function to compare two flat boards for equality
+bool ChessBoard::areBoardsEqual(const FlatCharacterBoard& board1, const FlatCharacterBoard& board2) {
+    INSTRUMENT_COUNT(GROUPING_COMPARISONS);
     return board1 == board2;
 }
 
@@ -227,6 +1550,20 @@ bool ChessBoard::areBoardsEqual(const CharacterBoard& board1, const CharacterBoa
  */
  std::vector<std::vector<CharacterBoard>> ChessBoard::groupSimilarBoards(const std::vector<CharacterBoard>& boards) {
     std::vector<std::vector<CharacterBoard>> groupedBoards;
+    groupSimilarBoards(boards, CancellationToken(), groupedBoards);
+    return groupedBoards;
+}
+
+/**
+ * @brief Groups similar chessboard configurations by transformations, stopping early if the token is raised
+ * 
+ * @param token Polled before each comparison against a group's first board
+ * @param groupedBoards Receives the groups, or the ones completed before the token was raised
+ * @return True if every board was grouped, false if the token stopped the grouping
+ */
+bool ChessBoard::groupSimilarBoards(const std::vector<CharacterBoard>& boards, const CancellationToken& token, std::vector<std::vector<CharacterBoard>>& groupedBoards) {
+    INSTRUMENT_SCOPE(GROUPING);
+    groupedBoards.clear();
     std::vector<bool> visited(boards.size(), false);  
 
     for (size_t i = 0; i < boards.size(); i++) {
@@ -241,6 +1578,7 @@ bool ChessBoard::areBoardsEqual(const CharacterBoard& board1, const CharacterBoa
         // Compare to every other unvisited board
         for (size_t j = i + 1; j < boards.size(); j++) {
             if (visited[j]) continue;
+            if (token.stopRequested()) { return false; }
 
             bool isSimilar = false;
             std::vector<CharacterBoard> transformations = getAllTransformations(boards[j]);
@@ -262,9 +1600,50 @@ bool ChessBoard::areBoardsEqual(const CharacterBoard& board1, const CharacterBoa
         groupedBoards.push_back(currentGroup);
     }
 
+    return true;
+}
+
+/**
+ * @brief Groups similar flat boards by transformations
+ * 
+ * @param boards A const ref. to a vector of `FlatCharacterBoard` objects
+ * @return A 2D vector of `FlatCharacterBoard` objects, one inner vector per group
+ */
+std::vector<std::vector<FlatCharacterBoard>> ChessBoard::groupSimilarBoards(const std::vector<FlatCharacterBoard>& boards) {
+    std::vector<std::vector<FlatCharacterBoard>> groupedBoards;
+    groupSimilarBoards(boards, CancellationToken(), groupedBoards);
     return groupedBoards;
 }
 
+/**
+ * @brief Groups similar flat boards by transformations, stopping early if the token is raised
+ * 
+ * @param token Polled before each board is grouped
+ * @param groupedBoards Receives the groups of the boards grouped before the token was raised
+ * @return True if every board was grouped, false if the token stopped the grouping
+ */
+bool ChessBoard::groupSimilarBoards(const std::vector<FlatCharacterBoard>& boards, const CancellationToken& token, std::vector<std::vector<FlatCharacterBoard>>& groupedBoards) {
+    INSTRUMENT_SCOPE(GROUPING);
+    groupedBoards.clear();
+
+    // Similar boards share the same set of transformations, so the least of them names the group
+    std::unordered_map<FlatCharacterBoard, size_t> groupOf;
+    groupOf.reserve(boards.size());
+
+    for (size_t i = 0; i < boards.size(); i++) {
+        if (token.stopRequested()) { return false; }
 
+        std::array<FlatCharacterBoard, 8> transformations = getAllTransformations(boards[i]);
+        size_t canonical = 0;
+        for (size_t k = 1; k < transformations.size(); k++) {
+            if (transformations[k] < transformations[canonical]) { canonical = k; }
+        }
 
+        // A new canonical board starts a group; groups stay in the order of their first board
+        auto found = groupOf.emplace(transformations[canonical], groupedBoards.size());
+        if (found.second) { groupedBoards.emplace_back(); }
+        groupedBoards[found.first->second].push_back(boards[i]);
+    }
 
+    return true;
+}
@@ -5,8 +5,19 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
+#include <cstdint>
+#include <string>
+#include <string_view>
 #include "pieces_module.hpp"
+#include "engine/Bitboard.hpp"
+#include "engine/BoardSize.hpp"
+#include "engine/CancellationToken.hpp"
+#include "engine/Evaluation.hpp"
+#include "engine/FlatBoard.hpp"
+#include "engine/Types.hpp"
+#include "engine/Move.hpp"
 
 /**
 Name: Kenny Zhou
@@ -15,9 +26,6 @@ Purpose: The hpp file for ChessBoard. Defines three functions: queenHelper, find
 
 class ChessBoard {
     private:
-        // Define board size (8x8)
-        static const int BOARD_LENGTH = 8;
-        
         bool playerOneTurn;
         
         std::string p1_color;
@@ -25,6 +33,133 @@ class ChessBoard {
 
         std::vector<std::vector<ChessPiece*>> board;
 
+        // Castling rights, one bit per side and direction
+        static constexpr int PLAYER_ONE_SHORT_CASTLE = 1;
+        static constexpr int PLAYER_ONE_LONG_CASTLE = 2;
+        static constexpr int PLAYER_TWO_SHORT_CASTLE = 4;
+        static constexpr int PLAYER_TWO_LONG_CASTLE = 8;
+        static constexpr int ALL_CASTLING_RIGHTS = 15;
+
+        /**
+         * @brief Everything makeMove() overwrites that unmakeMove() cannot work out from the move itself
+         */
+        struct UndoRecord {
+            Move move;
+            uint64_t key;                // Zobrist key before the move
+            uint8_t captured;            // Piece code of the captured piece, or PieceCodes::NO_PIECE
+            uint8_t castlingRights;
+            int8_t enPassantSquare;
+            int halfmoveClock;
+            bool moverHadMoved;          // has_moved_ of the moving piece before the move
+            bool rookHadMoved;           // has_moved_ of the castling rook before the move
+            ChessPiece* capturedPiece;   // Taken off the board, owned by this record until the move is unmade
+            ChessPiece* promotedPawn;    // The pawn replaced by a promotion, owned by this record until the move is unmade
+        };
+
+        // Bitboard view of the board, kept in sync with `board` by makeMove() / unmakeMove()
+        Bitboard pieceBoards[SIDE_COUNT][PIECE_KIND_COUNT];
+        Bitboard sideBoards[SIDE_COUNT];
+        Bitboard occupancy;
+        uint8_t mailbox[Bitboards::SQUARE_COUNT];         // Piece code on each square
+
+        // Attack maps: the attack set of the piece on each square, and their union per side
+        Bitboard squareAttacks[Bitboards::SQUARE_COUNT];
+        Bitboard attackMaps[SIDE_COUNT];
+
+        int castlingRights;
+        int enPassantSquare;   // Square a pawn may capture onto en passant, or Bitboards::NO_SQUARE
+        int halfmoveClock;     // Moves since the last capture or pawn move
+        int fullmoveNumber;    // Starts at 1 and is incremented after PLAYER_ONE moves
+
+        uint64_t zobristKey;   // Updated incrementally; see hash()
+
+        // Evaluation terms, updated incrementally with the pieces; see evaluate()
+        int middlegameScore;   // Material + piece-square tables, from PLAYER_ONE's point of view
+        int endgameScore;
+        int gamePhase;
+
+        std::vector<UndoRecord> history;
+
+        /**
+         * @brief Debug builds (EVAL_DEBUG) only: aborts if the incremental evaluation differs from a full recomputation
+         */
+        void verifyEvaluation() const;
+
+        /**
+         * @brief Rebuilds the bitboards, mailbox, attack maps and evaluation terms from a piece code per square
+         * @note Leaves the castling rights, en passant square, counters, Zobrist key and history to the caller
+         */
+        void loadPieceCodes(const uint8_t* codes);
+
+        /**
+         * @brief Rebuilds the bitboards, mailbox, attack maps and castling rights from the pieces on `board`
+         * @post Castling rights are granted for every unmoved King on its home cell with an unmoved Rook in the corner.
+         *       There is no en passant square, and the move counters are reset.
+         */
+        void syncFromBoard();
+
+        /**
+         * @brief Places / removes / relocates a piece code in the bitboards, mailbox and Zobrist key (not in `board`)
+         */
+        void putPiece(const int& sq, const uint8_t& code);
+        void removePiece(const int& sq);
+        void relocatePiece(const int& from, const int& to);
+
+        /**
+         * @brief Gets the squares attacked by the piece on `sq` with the current occupancy
+         */
+        Bitboard attacksFrom(const int& sq) const;
+
+        /**
+         * @brief Recomputes the attack sets that the changed squares may have affected, then the per-side attack maps
+         * @param changed The squares whose contents changed
+         * @note Only the pieces on the changed squares and the sliders whose rays reach them can have new attack sets
+         */
+        void refreshAttacks(const Bitboard& changed);
+
+        /**
+         * @brief Appends a pawn move, expanding it into the four promotions when it reaches the last row
+         */
+        static void addPawnMove(MoveList& moves, const int& from, const int& to, const bool& capture);
+
+        /**
+         * @brief Determines whether an en passant capture leaves the mover's King safe
+         * @note Two pawns leave the same row at once, so this is checked by replaying the occupancy rather than with pin rays
+         */
+        bool isEnPassantLegal(const int& from, const int& to) const;
+
+        /**
+         * @brief Moves the ChessPiece* at `from` on `board` to `to`, updating its row and column
+         */
+        void relocateBoardPiece(const int& from, const int& to);
+
+        /**
+         * @brief Gets the piece kind for a ChessPiece, based on its type string
+         * @return NO_PIECE_KIND if the type is not one of the six chess pieces
+         */
+        static int kindOf(const ChessPiece& piece);
+
+        /**
+         * @brief Deletes every piece owned by the board: those on it, and those parked in the move history
+         */
+        void releasePieces();
+
+        /**
+         * @brief Copies the other board's state into this one, cloning every piece it owns
+         * @pre This board owns no pieces
+         */
+        void copyFrom(const ChessBoard& other);
+
+        /**
+         * @brief Allocates a copy of a piece (including its moved flag), or returns nullptr for nullptr
+         */
+        static ChessPiece* clonePiece(const ChessPiece* piece);
+
+        /**
+         * @brief Allocates a ChessPiece of the given kind
+         */
+        static ChessPiece* createPiece(const int& kind, const std::string& color, const int& row, const int& col, const bool& movingUp);
+
     public:
         /**
          * Default constructor. 
@@ -81,11 +216,256 @@ class ChessBoard {
          */
         ~ChessBoard();
 
+        /**
+         * @brief Copy constructor. Every piece on the board, and every piece parked in the move history, is cloned,
+         *        so the copy owns its own pieces and can unmake the moves made on the original.
+         */
+        ChessBoard(const ChessBoard& other);
+
+        /**
+         * @brief Copy assignment. Releases this board's pieces, then clones the other board's (see the copy constructor).
+         */
+        ChessBoard& operator=(const ChessBoard& other);
+
+        // =============== FEN ===============
+
+        /**
+         * @brief Sets up the position described by a FEN record, eg.
+         *        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1" for the default board.
+         *        Lowercase pieces belong to PLAYER_ONE (p1_color, rank 8 = row 0, moving up), uppercase to PLAYER_TWO;
+         *        "b" means it is player one's turn. Files run from column 7 ('a') down to column 0 ('h').
+         * @param fen Placement, side to move, castling rights and en passant square, optionally followed by
+         *        the halfmove clock and fullmove number (default 0 and 1). Fields are separated by spaces.
+         * @param error If not null, receives a description of the problem when the record is rejected
+         * @return True if the position was loaded. On false the board is left unchanged.
+         * @note The record is read in place, without copying or splitting it. Castling rights must match a King and Rook on
+         *       their home cells. An en passant square is kept only if a pawn can actually capture onto it.
+         *       The move history is cleared, and the ChessPieces already on the board are reused where possible, so
+         *       loading many positions into one board allocates next to nothing.
+         */
+        bool fromFEN(std::string_view fen, std::string* error = nullptr);
+
+        /**
+         * @brief Sets up a position from a piece code per square and the rest of the game state, checking it as fromFEN() does
+         * @param codes 64 piece codes (see engine/Types.hpp), PieceCodes::NO_PIECE on empty squares
+         * @param p1Turn Whether it is player one's turn
+         * @param rights Castling rights (see the *_CASTLE constants)
+         * @param passed The square skipped by the last double pawn push, or Bitboards::NO_SQUARE
+         * @param halfmoves Moves since the last capture or pawn move
+         * @param fullmoves Starts at 1 and is incremented after PLAYER_ONE moves
+         * @param error If not null, receives a description of the problem when the position is rejected
+         * @return True if the position was loaded. On false the board is left unchanged.
+         * @note Loads exactly like fromFEN() (kept en passant squares, cleared history, recycled pieces), minus the parsing
+         */
+        bool setPosition(const uint8_t* codes, const bool& p1Turn, const int& rights, const int& passed,
+                         const int& halfmoves, const int& fullmoves, std::string* error = nullptr);
+
+        /**
+         * @brief Describes the position as a FEN record; fromFEN(toFEN()) reproduces it exactly
+         */
+        std::string toFEN() const;
+
+        // =============== Position state ===============
+
+        /**
+         * @brief Gets the side whose turn it is (PLAYER_ONE when playerOneTurn is set)
+         */
+        int sideToMove() const { return playerOneTurn ? PLAYER_ONE : PLAYER_TWO; }
+
+        /**
+         * @brief Gets the squares holding pieces of the given side and kind
+         */
+        Bitboard pieces(const int& side, const int& kind) const { return pieceBoards[side][kind]; }
+
+        /**
+         * @brief Gets the squares holding pieces of the given side
+         */
+        Bitboard sidePieces(const int& side) const { return sideBoards[side]; }
+
+        /**
+         * @brief Gets the squares holding any piece
+         */
+        Bitboard occupied() const { return occupancy; }
+
+        /**
+         * @brief Gets the piece code (see engine/Types.hpp) on a square, or PieceCodes::NO_PIECE if it is empty
+         */
+        uint8_t pieceCodeAt(const int& sq) const { return mailbox[sq]; }
+
+        /**
+         * @brief Gets the square of the given side's King, or Bitboards::NO_SQUARE if it has none
+         */
+        int kingSquare(const int& side) const;
+
+        /**
+         * @brief Gets the current castling rights as a bit set (see the *_CASTLE constants)
+         */
+        int getCastlingRights() const { return castlingRights; }
+
+        /**
+         * @brief Gets the square a pawn may capture onto en passant, or Bitboards::NO_SQUARE
+         */
+        int getEnPassantSquare() const { return enPassantSquare; }
+
+        /**
+         * @brief Gets the 64-bit Zobrist key of the position
+         * @note Covers every piece and its square, the side to move, the castling rights and the en passant column.
+         *       It is kept up to date by makeMove() / unmakeMove(), so reading it is free.
+         */
+        uint64_t hash() const { return zobristKey; }
+
+        /**
+         * @brief Recomputes the Zobrist key from scratch, for verifying the incremental key returned by hash()
+         */
+        uint64_t computeHash() const;
+
+        // =============== Evaluation ===============
+
+        /**
+         * @brief Gets the static evaluation in centipawns, from the side to move's point of view
+         * @note Material and piece-square terms are kept up to date by makeMove() / unmakeMove(), so this is a blend
+         *       of two running sums by the game phase. See Evaluation.
+         */
+        int evaluate() const {
+            int score = Evaluation::blend(middlegameScore, endgameScore, gamePhase);
+            return playerOneTurn ? score : -score;
+        }
+
+        /**
+         * @brief Recomputes the evaluation from scratch, for verifying the incremental one returned by evaluate()
+         */
+        int computeEvaluation() const;
+
+        /**
+         * @brief Gets the game phase: Evaluation::PHASE_MAX with all minor and major pieces on the board, 0 with none
+         */
+        int getGamePhase() const { return gamePhase; }
+
+        // =============== Making moves ===============
+
+        /**
+         * @brief Plays a move for the side to move
+         * @pre The move is pseudo-legal in the current position
+         * @post `board`, the bitboards, the attack maps and the position state all reflect the move. Captured pieces
+         *       are taken off the board (row and column -1) but stay allocated until the move is unmade or the board is destroyed.
+         *       A promotion allocates the new piece and parks the pawn the same way.
+         */
+        void makeMove(const Move& move);
+
+        /**
+         * @brief Takes back the last move played with makeMove()
+         * @pre At least one move has been made
+         */
+        void unmakeMove();
+
+        /**
+         * @brief Gets the number of moves that can currently be unmade
+         */
+        int plyCount() const { return int(history.size()); }
+
+        // =============== Attack queries ===============
+
+        /**
+         * @brief Determines whether any piece of `side` attacks the square
+         * @note Constant time: the per-side attack maps are kept up to date as moves are made and unmade
+         */
+        bool isAttacked(const int& sq, const int& side) const { return (attackMaps[side] & Bitboards::squareBit(sq)) != 0; }
+
+        /**
+         * @brief Gets every square attacked by at least one piece of `side`
+         */
+        Bitboard attackMap(const int& side) const { return attackMaps[side]; }
+
+        /**
+         * @brief Gets the squares of every piece (of either side) that attacks `sq`
+         * @note Constant time: one lookup per piece kind, intersected with that kind's bitboard
+         */
+        Bitboard attackersOf(const int& sq) const { return attackersOf(sq, occupancy); }
+
+        /**
+         * @brief Gets the squares of every piece in `occupied` (of either side) that attacks `sq`, as if only the squares in `occupied` held pieces
+         */
+        Bitboard attackersOf(const int& sq, const Bitboard& occupied) const;
+
+        /**
+         * @brief Gets the enemy pieces currently giving check to the side to move
+         */
+        Bitboard checkers() const;
+
+        // =============== Legal moves ===============
+
+        /**
+         * @brief Generates every strictly legal move for the side to move
+         *
+         * Pin rays and the check mask are computed once per call, so pinned pieces only slide along their pin,
+         * and when in check only captures of the checker, blocks and King moves are produced. No move is ever
+         * made and tested afterwards.
+         *
+         * @param moves The list the moves are appended to. It is cleared first.
+         */
+        void generateLegalMoves(MoveList& moves) const;
+
+        /**
+         * @brief Determines whether the side to move is in check
+         */
+        bool isCheck() const;
+
+        /**
+         * @brief Determines whether the side to move is in check and has no legal move
+         */
+        bool isCheckmate() const;
+
+        /**
+         * @brief Determines whether the side to move is not in check but has no legal move
+         */
+        bool isStalemate() const;
+
+        /**
+         * @brief Determines whether the current position already occurred since the last irreversible move
+         * @note Uses the Zobrist keys saved in the move history, so only positions reached with makeMove() are seen
+         */
+        bool isRepetition() const;
+
+        /**
+         * @brief Determines whether the position is drawn by repetition or by the fifty-move rule
+         */
+        bool isDraw() const;
+
+        /**
+         * @brief Gets the number of moves since the last capture or pawn move
+         */
+        int getHalfmoveClock() const { return halfmoveClock; }
+
+        /**
+         * @brief Gets the fullmove number, which starts at 1 and is incremented after PLAYER_ONE moves
+         */
+        int getFullmoveNumber() const { return fullmoveNumber; }
+
+        // =============== Perft ===============
+
+        /**
+         * @brief Counts the leaf nodes of the legal move tree to the given depth (performance test)
+         * @param depth The number of plies to expand. perft(0) is 1.
+         * @note The last ply is counted from the size of the move list rather than played out ("bulk counting").
+         *       The board is left exactly as it was.
+         */
+        uint64_t perft(const int& depth);
+
+        /**
+         * @brief Runs perft(depth - 1) below each legal move, for finding which move a wrong count comes from
+         * @param depth The total depth, including the root move. Must be at least 1.
+         * @return Each root move paired with its subtree count, in generation order
+         */
+        std::vector<std::pair<Move, uint64_t>> perftDivide(const int& depth);
+
         // MY CODE BELOW 
         
         // Alias for readability
         typedef std::vector<std::vector<char>> CharacterBoard;
 
+        // A CharacterBoard in one contiguous block (see engine/FlatBoard.hpp)
+        typedef FlatBoard<BOARD_LENGTH> FlatCharacterBoard;
+
         /**
         * @brief A STATIC helper function for recursively solving the 8-queens problem.
         * 
@@ -96,8 +476,11 @@ class ChessBoard {
         * @param board A (non-const) reference to a 2D vector of ChessPiece*, representing the current board configuration
         * @param placedQueens A (non-const) reference to a vector storing Queen*, which represents the queens we've placed so far
         * @param allBoards A (non-const) reference to a vector of CharacterBoard objects storing all the solutions we've found thus far
+        * @param token If not null, polled at every node; once it is raised the search unwinds (freeing its queens)
+        * @return False if the token stopped the search before every placement was tried
         */
-        static void queenHelper(const int& col, std::vector<std::vector<ChessPiece*>>& board, std::vector<Queen*>& placedQueens, std::vector<CharacterBoard>& allBoards);
+        static bool queenHelper(const int& col, std::vector<std::vector<ChessPiece*>>& board, std::vector<Queen*>& placedQueens, std::vector<CharacterBoard>& allBoards,
+                                const CancellationToken* token = nullptr);
 
         /**
         * @brief Finds all possible solutions to the 8-queens problem.
@@ -105,9 +488,57 @@ class ChessBoard {
         * @return A vector of CharacterBoard objects, 
         *         each representing a unique solution 
         *         to the 8-queens problem.
+        * @note QueenSolver<N> (engine/QueenSolver.hpp) solves the puzzle for any board size from 4x4 to 32x32
         */
         static std::vector<CharacterBoard> findAllQueenPlacements();
 
+        /**
+        * @brief Finds all solutions to the 8-queens problem, stopping early if the token is raised
+        * 
+        * @param token Polled at every node of the search (see CancellationToken; eg. a Scheduler job's token)
+        * @param solutions Receives the solutions, or the ones found before the token was raised
+        * @return True if the search finished, false if the token stopped it
+        */
+        static bool findAllQueenPlacements(const CancellationToken& token, std::vector<CharacterBoard>& solutions);
+
+        /**
+        * @brief Finds all solutions to the 8-queens problem as flat boards
+        * 
+        * @return The same solutions as findAllQueenPlacements(), in the same order
+        * @note Solved by QueenSolver<BOARD_LENGTH>, which builds each board in place instead of converting Queen pieces
+        */
+        static std::vector<FlatCharacterBoard> findAllFlatQueenPlacements();
+
+        /**
+        * @brief Finds all solutions to the 8-queens problem as flat boards, stopping early if the token is raised
+        * 
+        * @param solutions Receives the solutions, or the ones found before the token was raised
+        * @return True if the search finished, false if the token stopped it
+        */
+        static bool findAllFlatQueenPlacements(const CancellationToken& token, std::vector<FlatCharacterBoard>& solutions);
+
+        /**
+        * @brief Finds one placement of n non-attacking queens on an n x n board, for n up to the millions
+        * 
+        * Rather than searching exhaustively, it builds a near-valid placement greedily, then repairs it with
+        * min-conflicts: each queen still attacked swaps rows with whichever of a few random queens removes the most
+        * attacks. Memory is linear in n: the permutation plus one counter per diagonal.
+        * 
+        * @param n The board size
+        * @param seed Seeds the random choices; each seed gives one fixed placement
+        * @return The row of the queen in each column, or an empty vector if there is no placement (n = 2 or 3)
+        */
+        static std::vector<uint32_t> findOneQueenPlacement(const int& n, const uint64_t& seed = 1);
+
+        /**
+        * @brief Finds one placement of n non-attacking queens, stopping early if the token is raised
+        * 
+        * @param token Polled between repair passes
+        * @param rows Receives the row of the queen in each column, or is left empty if no placement was found
+        * @return True if a placement was found, false if there is none or the token stopped the search
+        */
+        static bool findOneQueenPlacement(const int& n, const CancellationToken& token, std::vector<uint32_t>& rows, const uint64_t& seed = 1);
+
         /**
         * @brief Groups similar chessboard configurations by transformations.
         * 
@@ -123,10 +554,47 @@ class ChessBoard {
         *         that are transformations of each other.
         */
         static std::vector<std::vector<CharacterBoard>> groupSimilarBoards(const std::vector<CharacterBoard>& boards);
+
+        /**
+        * @brief Groups similar chessboard configurations by transformations, stopping early if the token is raised
+        * 
+        * @param token Polled before each comparison against a group's first board
+        * @param groupedBoards Receives the groups, or the ones completed before the token was raised
+        * @return True if every board was grouped, false if the token stopped the grouping
+        */
+        static bool groupSimilarBoards(const std::vector<CharacterBoard>& boards, const CancellationToken& token, std::vector<std::vector<CharacterBoard>>& groupedBoards);
+
+        /**
+        * @brief Groups similar flat boards by transformations
+        * 
+        * Produces the same groups, in the same order, as the CharacterBoard version. Rather than comparing every
+        * pair of boards, each board is keyed by its canonical form (the least of its eight transformations), and
+        * the keys are looked up in a hash table, so the work grows linearly with the number of boards.
+        * 
+        * @param boards A const ref. to a vector of `FlatCharacterBoard` objects
+        * @return A 2D vector of `FlatCharacterBoard` objects, one inner vector per group
+        */
+        static std::vector<std::vector<FlatCharacterBoard>> groupSimilarBoards(const std::vector<FlatCharacterBoard>& boards);
+
+        /**
+        * @brief Groups similar flat boards by transformations, stopping early if the token is raised
+        * 
+        * @param token Polled before each board is grouped
+        * @param groupedBoards Receives the groups of the boards grouped before the token was raised
+        * @return True if every board was grouped, false if the token stopped the grouping
+        */
+        static bool groupSimilarBoards(const std::vector<FlatCharacterBoard>& boards, const CancellationToken& token, std::vector<std::vector<FlatCharacterBoard>>& groupedBoards);
  
         // Helper function to generate all transformations of a given board
         static std::vector<CharacterBoard> getAllTransformations(const CharacterBoard& board);
+
+        // Helper function to generate the eight distinct transformations of a flat board (the four rotations, then
+        // each of them flipped across the vertical axis), without allocating
+        static std::array<FlatCharacterBoard, 8> getAllTransformations(const FlatCharacterBoard& board);
  
         // Helper function to compare two boards for equality
         static bool areBoardsEqual(const CharacterBoard& board1, const CharacterBoard& board2);
+
+        // Helper function to compare two flat boards for equality with a single memcmp
+        static bool areBoardsEqual(const FlatCharacterBoard& board1, const FlatCharacterBoard& board2);
 };
\ No newline at end of file
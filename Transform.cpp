@@ -1,4 +1,5 @@
 #include "Transform.hpp"
+#include "engine/Instrumentation.hpp"
 /**
 Name: Kenny Zhou
 Date: 4/25/25
@@ -15,6 +16,7 @@ Purpose: The cpp file for Transform namespace. It implements the functions rotat
 template <typename T>
 std::vector<std::vector<T>> Transform::rotate(const std::vector<std::vector<T>>& matrix) {
     // your code here.
+    INSTRUMENT_COUNT(BOARD_TRANSFORMS);
     int n = matrix.size();
     // Create a new matrix for the result
     std::vector<std::vector<T>> rotated(n, std::vector<T>(n));
@@ -40,6 +42,7 @@ std::vector<std::vector<T>> Transform::rotate(const std::vector<std::vector<T>>&
 template <typename T>
 std::vector<std::vector<T>> Transform::flipAcrossVertical(const std::vector<std::vector<T>>& matrix) {
     // your code here
+    INSTRUMENT_COUNT(BOARD_TRANSFORMS);
     int n = matrix.size();
     // Create a new matrix for the result
     std::vector<std::vector<T>> flipped(n, std::vector<T>(n));
@@ -65,6 +68,7 @@ std::vector<std::vector<T>> Transform::flipAcrossVertical(const std::vector<std:
 template <typename T>
 std::vector<std::vector<T>> Transform::flipAcrossHorizontal(const std::vector<std::vector<T>>& matrix) {
     // your code here
+    INSTRUMENT_COUNT(BOARD_TRANSFORMS);
     int n = matrix.size();
     // Create a new matrix for the result
     std::vector<std::vector<T>> flipped(n, std::vector<T>(n));
@@ -79,5 +83,62 @@ std::vector<std::vector<T>> Transform::flipAcrossHorizontal(const std::vector<st
     return flipped;
 }
 
+/**
+ * @brief Rotates a flat board 90 degrees clockwise, without allocating
+ * 
+ * @param board A const reference to an N x N FlatBoard
+ * @return A new FlatBoard representing the rotated board
+ */
+template <int N>
+FlatBoard<N> Transform::rotate(const FlatBoard<N>& board) {
+    INSTRUMENT_COUNT(BOARD_TRANSFORMS);
+    FlatBoard<N> rotated;
 
+    // Column j of the result is row N - 1 - j of the board, read top to bottom
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) {
+            rotated(j, N - 1 - i) = board(i, j);
+        }
+    }
 
+    return rotated;
+}
+
+/**
+ * @brief Swaps the cells of a flat board across its vertical axis of symmetry, without allocating
+ * 
+ * @param board A const reference to an N x N FlatBoard
+ * @return A new FlatBoard representing the transformed board
+ */
+template <int N>
+FlatBoard<N> Transform::flipAcrossVertical(const FlatBoard<N>& board) {
+    INSTRUMENT_COUNT(BOARD_TRANSFORMS);
+    FlatBoard<N> flipped;
+
+    // Each row is copied back to front
+    for (int i = 0; i < N; ++i) {
+        const char* row = board.data() + i * N;
+        std::reverse_copy(row, row + N, flipped.data() + i * N);
+    }
+
+    return flipped;
+}
+
+/**
+ * @brief Swaps the rows of a flat board across its horizontal axis of symmetry, without allocating
+ * 
+ * @param board A const reference to an N x N FlatBoard
+ * @return A new FlatBoard representing the transformed board
+ */
+template <int N>
+FlatBoard<N> Transform::flipAcrossHorizontal(const FlatBoard<N>& board) {
+    INSTRUMENT_COUNT(BOARD_TRANSFORMS);
+    FlatBoard<N> flipped;
+
+    // Rows are contiguous, so each one moves with a single copy
+    for (int i = 0; i < N; ++i) {
+        std::memcpy(flipped.data() + (N - 1 - i) * N, board.data() + i * N, N);
+    }
+
+    return flipped;
+}
@@ -6,6 +6,7 @@
  #pragma once 
  #include <vector>
  #include <algorithm>
+ #include "engine/FlatBoard.hpp"
 
 /**
 Name: Kenny Zhou
@@ -45,6 +46,33 @@ namespace Transform {
     */
    template <typename T>
    std::vector<std::vector<T>> flipAcrossHorizontal(const std::vector<std::vector<T>>& matrix);
+
+   /**
+    * @brief Rotates a flat board 90 degrees clockwise, without allocating
+    * 
+    * @param board A const reference to an N x N FlatBoard
+    * @return A new FlatBoard representing the rotated board
+    */
+   template <int N>
+   FlatBoard<N> rotate(const FlatBoard<N>& board);
+
+   /**
+    * @brief Swaps the cells of a flat board across its vertical axis of symmetry, without allocating
+    * 
+    * @param board A const reference to an N x N FlatBoard
+    * @return A new FlatBoard representing the transformed board
+    */
+   template <int N>
+   FlatBoard<N> flipAcrossVertical(const FlatBoard<N>& board);
+
+   /**
+    * @brief Swaps the rows of a flat board across its horizontal axis of symmetry, without allocating
+    * 
+    * @param board A const reference to an N x N FlatBoard
+    * @return A new FlatBoard representing the transformed board
+    */
+   template <int N>
+   FlatBoard<N> flipAcrossHorizontal(const FlatBoard<N>& board);
  };
  
  #include "Transform.cpp"
\ No newline at end of file
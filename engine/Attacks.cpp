@@ -0,0 +1,185 @@
+#include "Attacks.hpp"
+#include "Prng.hpp"
+
+namespace Attacks {
+    Magic rookMagics[Bitboards::SQUARE_COUNT];
+    Magic bishopMagics[Bitboards::SQUARE_COUNT];
+    Bitboard knightAttacks[Bitboards::SQUARE_COUNT];
+    Bitboard kingAttacks[Bitboards::SQUARE_COUNT];
+    Bitboard pawnAttacks[2][Bitboards::SQUARE_COUNT];
+    Bitboard betweenSquares[Bitboards::SQUARE_COUNT][Bitboards::SQUARE_COUNT];
+    Bitboard lineSquares[Bitboards::SQUARE_COUNT][Bitboards::SQUARE_COUNT];
+    Bitboard emptyBoardAttacks[PIECE_KIND_COUNT][Bitboards::SQUARE_COUNT];
+}
+
+namespace {
+    // Total table sizes when every square gets 2^(relevant bits) entries
+    const int ROOK_TABLE_SIZE = 0x19000;
+    const int BISHOP_TABLE_SIZE = 0x1480;
+
+    Bitboard rookTable[ROOK_TABLE_SIZE];
+    Bitboard bishopTable[BISHOP_TABLE_SIZE];
+
+    const int ROOK_DIRECTIONS[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    const int BISHOP_DIRECTIONS[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+    const Bitboard ROW_0 = 0xFFULL;
+    const Bitboard COL_0 = 0x0101010101010101ULL;
+
+    bool onBoard(const int& row, const int& col) {
+        return row >= 0 && row < 8 && col >= 0 && col < 8;
+    }
+
+    /**
+     * @brief Walks each direction from `sq` one cell at a time until it runs off the board or hits a blocker
+     * @note This is the slow reference the lookup tables are built from
+     */
+    Bitboard slidingAttack(const int directions[4][2], const int& sq, const Bitboard& occupied) {
+        Bitboard attacks = 0;
+        for (int d = 0; d < 4; d++) {
+            int row = Bitboards::rowOf(sq) + directions[d][0];
+            int col = Bitboards::colOf(sq) + directions[d][1];
+            while (onBoard(row, col)) {
+                Bitboard bit = Bitboards::squareBit(Bitboards::square(row, col));
+                attacks |= bit;
+                if (occupied & bit) { break; }
+                row += directions[d][0];
+                col += directions[d][1];
+            }
+        }
+        return attacks;
+    }
+
+    /**
+     * @brief Gets the set of (row, col) offsets from `sq` that land on the board
+     */
+    Bitboard leaperAttack(const int offsets[][2], const int& count, const int& sq) {
+        Bitboard attacks = 0;
+        for (int i = 0; i < count; i++) {
+            int row = Bitboards::rowOf(sq) + offsets[i][0];
+            int col = Bitboards::colOf(sq) + offsets[i][1];
+            if (onBoard(row, col)) { attacks |= Bitboards::squareBit(Bitboards::square(row, col)); }
+        }
+        return attacks;
+    }
+
+    /**
+     * @brief Fills in the Magic entries and the shared attack table for one sliding piece type
+     *
+     * For every square, each subset of the relevant blockers is enumerated (Carry-Rippler trick) and paired with its
+     * reference attack set. Without PEXT, sparse random candidates are then tried until one maps every subset to an
+     * index without a destructive collision. The per-row seeds keep the search short and fully deterministic.
+     */
+    void initMagics(Bitboard table[], Attacks::Magic magics[], const int directions[4][2]) {
+        static Bitboard reference[4096];
+        int size = 0;
+#if !defined(USE_PEXT)
+        // Only the magic number search needs the subsets themselves and the slots claimed per attempt
+        static const uint64_t SEEDS[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+        static Bitboard occupancy[4096];
+        static int epoch[4096];
+        int attempt = 0;
+#endif
+
+        for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+            int row = Bitboards::rowOf(sq);
+            int col = Bitboards::colOf(sq);
+
+            // Blockers on the board edge never change the attack set, so they are left out of the mask
+            Bitboard edges = (((ROW_0 | (ROW_0 << 56)) & ~(ROW_0 << (8 * row))) |
+                              ((COL_0 | (COL_0 << 7)) & ~(COL_0 << col)));
+
+            Attacks::Magic& m = magics[sq];
+            m.mask = slidingAttack(directions, sq, 0) & ~edges;
+            m.shift = 64 - Bitboards::popCount(m.mask);
+            m.attacks = (sq == 0) ? table : magics[sq - 1].attacks + size;
+
+            size = 0;
+            Bitboard subset = 0;
+            do {
+                reference[size] = slidingAttack(directions, sq, subset);
+#if defined(USE_PEXT)
+                m.attacks[_pext_u64(subset, m.mask)] = reference[size];
+#else
+                occupancy[size] = subset;
+#endif
+                size++;
+                subset = (subset - m.mask) & m.mask;
+            } while (subset);
+
+#if !defined(USE_PEXT)
+            Prng rng(SEEDS[row]);
+            for (int i = 0; i < size; ) {
+                // Reject candidates that spread too few bits into the top byte; they rarely work
+                for (m.magic = 0; Bitboards::popCount((m.magic * m.mask) >> 56) < 6; ) {
+                    m.magic = rng.nextSparse();
+                }
+
+                // Every subset must land on a fresh slot, or on a slot that already holds the same attack set
+                for (++attempt, i = 0; i < size; i++) {
+                    unsigned idx = m.index(occupancy[i]);
+                    if (epoch[idx] < attempt) {
+                        epoch[idx] = attempt;
+                        m.attacks[idx] = reference[i];
+                    } else if (m.attacks[idx] != reference[i]) {
+                        break;
+                    }
+                }
+            }
+#endif
+        }
+    }
+
+    // Builds the tables before main() runs
+    struct Initializer {
+        Initializer() { Attacks::init(); }
+    } initializer;
+}
+
+void Attacks::init() {
+    static bool initialized = false;
+    if (initialized) { return; }
+    initialized = true;
+
+    static const int KNIGHT_OFFSETS[8][2] = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+    static const int KING_OFFSETS[8][2] = { {1, -1}, {1, 0}, {1, 1}, {0, -1}, {0, 1}, {-1, -1}, {-1, 0}, {-1, 1} };
+    static const int PAWN_DOWN_OFFSETS[2][2] = { {-1, -1}, {-1, 1} };
+    static const int PAWN_UP_OFFSETS[2][2] = { {1, -1}, {1, 1} };
+
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        knightAttacks[sq] = leaperAttack(KNIGHT_OFFSETS, 8, sq);
+        kingAttacks[sq] = leaperAttack(KING_OFFSETS, 8, sq);
+        pawnAttacks[0][sq] = leaperAttack(PAWN_DOWN_OFFSETS, 2, sq);
+        pawnAttacks[1][sq] = leaperAttack(PAWN_UP_OFFSETS, 2, sq);
+    }
+
+    initMagics(rookTable, rookMagics, ROOK_DIRECTIONS);
+    initMagics(bishopTable, bishopMagics, BISHOP_DIRECTIONS);
+
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        emptyBoardAttacks[PAWN_KIND][sq] = 0;
+        emptyBoardAttacks[KNIGHT_KIND][sq] = knight(sq);
+        emptyBoardAttacks[BISHOP_KIND][sq] = bishop(sq, 0);
+        emptyBoardAttacks[ROOK_KIND][sq] = rook(sq, 0);
+        emptyBoardAttacks[QUEEN_KIND][sq] = queen(sq, 0);
+        emptyBoardAttacks[KING_KIND][sq] = king(sq);
+    }
+
+    for (int a = 0; a < Bitboards::SQUARE_COUNT; a++) {
+        for (int b = 0; b < Bitboards::SQUARE_COUNT; b++) {
+            betweenSquares[a][b] = 0;
+            lineSquares[a][b] = 0;
+            if (a == b) { continue; }
+
+            Bitboard bitA = Bitboards::squareBit(a);
+            Bitboard bitB = Bitboards::squareBit(b);
+            if (rook(a, 0) & bitB) {
+                lineSquares[a][b] = (rook(a, 0) & rook(b, 0)) | bitA | bitB;
+                betweenSquares[a][b] = rook(a, bitB) & rook(b, bitA);
+            } else if (bishop(a, 0) & bitB) {
+                lineSquares[a][b] = (bishop(a, 0) & bishop(b, 0)) | bitA | bitB;
+                betweenSquares[a][b] = bishop(a, bitB) & bishop(b, bitA);
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * @namespace Attacks
+ * @brief Precomputed attack lookups for every piece type on the 8x8 board
+ *
+ * Sliding pieces (Rook, Bishop, Queen) are answered with magic bitboards: the blockers relevant to a square
+ * are hashed into a perfect index of a precomputed attack table, so the full attack set for any occupancy
+ * costs one multiply, one shift and one load. Building with PEXT=1 (see the Makefile) swaps the multiply-shift
+ * hash for the BMI2 `pext` instruction on CPUs that support it. Both paths share the same tables.
+ *
+ * The tables are filled in once, before main() runs.
+ */
+
+#pragma once
+
+#include "Bitboard.hpp"
+#include "Types.hpp"
+
+#if defined(USE_PEXT)
+#include <immintrin.h>
+#endif
+
+namespace Attacks {
+    /**
+     * @brief The per-square data needed to index a sliding attack table
+     */
+    struct Magic {
+        Bitboard mask;      // Squares whose occupancy can change the attack set (board edges excluded)
+        Bitboard magic;     // Multiplier that maps every subset of mask to a unique index
+        Bitboard* attacks;  // This square's slice of the shared attack table
+        unsigned shift;     // 64 - popCount(mask)
+
+        /**
+         * @brief Maps an occupancy to its index in this square's attack table
+         */
+        unsigned index(const Bitboard& occupied) const {
+#if defined(USE_PEXT)
+            return unsigned(_pext_u64(occupied, mask));
+#else
+            return unsigned(((occupied & mask) * magic) >> shift);
+#endif
+        }
+    };
+
+    // Lookup tables, filled in by init()
+    extern Magic rookMagics[Bitboards::SQUARE_COUNT];
+    extern Magic bishopMagics[Bitboards::SQUARE_COUNT];
+    extern Bitboard knightAttacks[Bitboards::SQUARE_COUNT];
+    extern Bitboard kingAttacks[Bitboards::SQUARE_COUNT];
+    extern Bitboard pawnAttacks[2][Bitboards::SQUARE_COUNT]; // Indexed by [movingUp][square]
+    extern Bitboard betweenSquares[Bitboards::SQUARE_COUNT][Bitboards::SQUARE_COUNT];
+    extern Bitboard lineSquares[Bitboards::SQUARE_COUNT][Bitboards::SQUARE_COUNT];
+    extern Bitboard emptyBoardAttacks[PIECE_KIND_COUNT][Bitboards::SQUARE_COUNT]; // Indexed by [PieceKind][square]
+
+    /**
+     * @brief Builds every lookup table. Safe to call more than once.
+     * @note This runs automatically during static initialization, so callers never need to call it themselves.
+     */
+    void init();
+
+    /**
+     * @brief Gets every square a Rook on `sq` attacks, given the occupied squares of the board
+     * @note The first blocker in each direction is included (it may be a capture)
+     */
+    inline Bitboard rook(const int& sq, const Bitboard& occupied) {
+        const Magic& m = rookMagics[sq];
+        return m.attacks[m.index(occupied)];
+    }
+
+    /**
+     * @brief Gets every square a Bishop on `sq` attacks, given the occupied squares of the board
+     */
+    inline Bitboard bishop(const int& sq, const Bitboard& occupied) {
+        const Magic& m = bishopMagics[sq];
+        return m.attacks[m.index(occupied)];
+    }
+
+    /**
+     * @brief Gets every square a Queen on `sq` attacks, given the occupied squares of the board
+     */
+    inline Bitboard queen(const int& sq, const Bitboard& occupied) {
+        return rook(sq, occupied) | bishop(sq, occupied);
+    }
+
+    /**
+     * @brief Gets every square a Knight on `sq` attacks
+     */
+    inline Bitboard knight(const int& sq) { return knightAttacks[sq]; }
+
+    /**
+     * @brief Gets every square a King on `sq` attacks
+     */
+    inline Bitboard king(const int& sq) { return kingAttacks[sq]; }
+
+    /**
+     * @brief Gets the two diagonal squares a Pawn on `sq` attacks
+     * @param movingUp Whether the pawn moves towards higher rows
+     */
+    inline Bitboard pawn(const bool& movingUp, const int& sq) { return pawnAttacks[movingUp][sq]; }
+
+    /**
+     * @brief Gets every square a piece of the given kind attacks from `sq` on an otherwise empty board
+     * @param kind KNIGHT_KIND ... KING_KIND. Pawns, whose moves depend on their direction, get an empty set.
+     */
+    inline Bitboard emptyBoard(const int& kind, const int& sq) { return emptyBoardAttacks[kind][sq]; }
+
+    /**
+     * @brief Gets the squares strictly between `a` and `b`
+     * @return An empty set if the two squares do not share a row, column or diagonal
+     */
+    inline Bitboard between(const int& a, const int& b) { return betweenSquares[a][b]; }
+
+    /**
+     * @brief Gets the full row, column or diagonal (edge to edge) that passes through `a` and `b`
+     * @return An empty set if the two squares do not share a row, column or diagonal
+     */
+    inline Bitboard line(const int& a, const int& b) { return lineSquares[a][b]; }
+}
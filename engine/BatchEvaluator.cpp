@@ -0,0 +1,170 @@
+#include "BatchEvaluator.hpp"
+#include <algorithm>
+#include "Evaluation.hpp"
+
+#ifdef USE_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Evaluation tables with an extra row for PieceCodes::NO_PIECE, so empty squares need no branch.
+    // The middlegame and endgame scores of a (code, square) are packed into one int as endgame * 65536 + middlegame,
+    // so one lookup and one addition handle both phases: every sum over a position stays far inside 16 bits.
+    const int ROWS = PieceCodes::CODE_COUNT + 1;
+
+    struct PackedTables {
+        alignas(32) int scores[ROWS * Bitboards::SQUARE_COUNT];
+        alignas(16) uint8_t phase[16];
+
+        PackedTables() {
+            Evaluation::init();
+            std::fill(scores, scores + ROWS * Bitboards::SQUARE_COUNT, 0);
+            std::fill(phase, phase + 16, 0);
+            for (int code = 0; code < PieceCodes::CODE_COUNT; code++) {
+                for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+                    scores[code * Bitboards::SQUARE_COUNT + sq] = pack(Evaluation::middlegame(uint8_t(code), sq),
+                                                                       Evaluation::endgame(uint8_t(code), sq));
+                }
+                phase[code] = uint8_t(Evaluation::phase(uint8_t(code)));
+            }
+        }
+
+        static int pack(const int& middlegame, const int& endgame) { return int(uint32_t(endgame) << 16) + middlegame; }
+    };
+
+    const PackedTables& tables() {
+        static const PackedTables TABLES;
+        return TABLES;
+    }
+
+    int unpackMiddlegame(const int& packed) { return int16_t(uint16_t(uint32_t(packed) & 0xFFFF)); }
+    int unpackEndgame(const int& packed) { return (packed - unpackMiddlegame(packed)) / 65536; }
+}
+
+/**
+ * @brief Constructs an empty batch with room for (at least) `capacity` positions
+ */
+BatchEvaluator::BatchEvaluator(const size_t& capacity) : size_{0}, capacity_{0} {
+    reserve(capacity);
+}
+
+/**
+ * @brief Makes room for (at least) `capacity` positions, keeping the ones already added
+ */
+void BatchEvaluator::reserve(const size_t& capacity) {
+    size_t rounded = (capacity + LANES - 1) / LANES * LANES;
+    if (rounded <= capacity_) { return; }
+
+    // Every plane moves, so the batch is re-laid out; unused lanes hold empty squares
+    std::vector<uint8_t> planes(Bitboards::SQUARE_COUNT * rounded, uint8_t(PieceCodes::NO_PIECE));
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        std::copy(planes_.begin() + sq * capacity_, planes_.begin() + sq * capacity_ + size_, planes.begin() + sq * rounded);
+    }
+    planes_.swap(planes);
+    playerOneTurn_.resize(rounded, 0);
+    capacity_ = rounded;
+}
+
+/**
+ * @brief Appends a copy of the position to the batch
+ */
+void BatchEvaluator::add(const ChessBoard& board) {
+    if (size_ == capacity_) { reserve(std::max(capacity_ * 2, LANES)); }
+
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        planes_[sq * capacity_ + size_] = board.pieceCodeAt(sq);
+    }
+    playerOneTurn_[size_] = board.sideToMove() == PLAYER_ONE;
+    size_++;
+}
+
+/**
+ * @brief Sums the tables for positions [begin, begin + LANES) into per-position totals
+ */
+void BatchEvaluator::sumScalar(const size_t& begin, int* packed, int* phase) const {
+    const PackedTables& table = tables();
+    std::fill(packed, packed + LANES, 0);
+    std::fill(phase, phase + LANES, 0);
+
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        const uint8_t* codes = &planes_[sq * capacity_ + begin];
+        for (size_t lane = 0; lane < LANES; lane++) {
+            packed[lane] += table.scores[codes[lane] * Bitboards::SQUARE_COUNT + sq];
+            phase[lane] += table.phase[codes[lane]];
+        }
+    }
+}
+
+#ifdef USE_AVX2
+void BatchEvaluator::sumAvx2(const size_t& begin, int* packed, int* phase) const {
+    const PackedTables& table = tables();
+    const __m128i phaseTable = _mm_load_si128(reinterpret_cast<const __m128i*>(table.phase));
+    __m256i packedSum = _mm256_setzero_si256();
+    __m128i phaseSum = _mm_setzero_si128();   // Bytes: a position's phase never exceeds 4 x 32 pieces
+
+    for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+        // Eight piece codes, widened to 32-bit table indices code * 64 + sq
+        __m128i codes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&planes_[sq * capacity_ + begin]));
+        __m256i index = _mm256_add_epi32(_mm256_slli_epi32(_mm256_cvtepu8_epi32(codes), 6), _mm256_set1_epi32(sq));
+
+        packedSum = _mm256_add_epi32(packedSum, _mm256_i32gather_epi32(table.scores, index, 4));
+        phaseSum = _mm_add_epi8(phaseSum, _mm_shuffle_epi8(phaseTable, codes));
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(packed), packedSum);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(phase), _mm256_cvtepu8_epi32(phaseSum));
+}
+#endif
+
+/**
+ * @brief Blends the totals of one block and writes the scores of its positions that are in the batch
+ */
+void BatchEvaluator::finish(const size_t& begin, const int* packed, const int* phase, int* scores) const {
+    size_t end = std::min(begin + LANES, size_);
+    for (size_t i = begin; i < end; i++) {
+        // Integer division makes the blend the one step that cannot be vectorized exactly, so it stays scalar
+        int lane = int(i - begin);
+        int score = Evaluation::blend(unpackMiddlegame(packed[lane]), unpackEndgame(packed[lane]), phase[lane]);
+        scores[i] = playerOneTurn_[i] ? score : -score;
+    }
+}
+
+/**
+ * @brief Scores every position in the batch, as ChessBoard::evaluate() would (side to move's point of view)
+ * @param scores Receives size() scores, in the order the positions were added
+ */
+void BatchEvaluator::evaluate(int* scores) const {
+#ifdef USE_AVX2
+    int packed[LANES];
+    int phase[LANES];
+    for (size_t begin = 0; begin < size_; begin += LANES) {
+        sumAvx2(begin, packed, phase);
+        finish(begin, packed, phase, scores);
+    }
+#else
+    evaluateScalar(scores);
+#endif
+}
+
+/**
+ * @brief Same as evaluate(), but always on the scalar path (for checking the SIMD one)
+ */
+void BatchEvaluator::evaluateScalar(int* scores) const {
+    int packed[LANES];
+    int phase[LANES];
+    for (size_t begin = 0; begin < size_; begin += LANES) {
+        sumScalar(begin, packed, phase);
+        finish(begin, packed, phase, scores);
+    }
+}
+
+/**
+ * @brief Checks whether evaluate() uses the AVX2 kernel (ie. the build defines USE_AVX2)
+ */
+bool BatchEvaluator::usesAvx2() {
+#ifdef USE_AVX2
+    return true;
+#else
+    return false;
+#endif
+}
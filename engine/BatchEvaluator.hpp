@@ -0,0 +1,82 @@
+/**
+ * @class BatchEvaluator
+ * @brief Evaluates many independent positions at once from a structure-of-arrays copy of them
+ *
+ * Positions are transposed on add() into 64 byte planes, one per square: plane `sq` holds the piece code on `sq`
+ * of every position in the batch, contiguously. evaluate() then walks the planes square by square, summing the
+ * Evaluation tables for a block of positions at a time. Built with AVX2=1 (-mavx2 -DUSE_AVX2) it handles eight
+ * positions per instruction with gathers; otherwise a scalar loop over the same layout is used. Either way the
+ * scores are bit-identical to ChessBoard::evaluate() on each position.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../ChessBoard.hpp"
+
+class BatchEvaluator {
+    public:
+        static constexpr size_t LANES = 8;     // Positions per AVX2 block; the capacity is kept a multiple of it
+
+    private:
+        std::vector<uint8_t> planes_;          // planes_[sq * capacity_ + i]: piece code on `sq` in position i
+        std::vector<uint8_t> playerOneTurn_;   // Side to move of each position
+        size_t size_;
+        size_t capacity_;
+
+        /**
+         * @brief Sums the tables for positions [begin, begin + LANES) into per-position totals
+         * @param packed Receives the middlegame and endgame sums of each position, packed into one int
+         * @param phase Receives the game phase of each position
+         */
+        void sumScalar(const size_t& begin, int* packed, int* phase) const;
+#ifdef USE_AVX2
+        void sumAvx2(const size_t& begin, int* packed, int* phase) const;
+#endif
+
+        /**
+         * @brief Blends the totals of one block and writes the scores of its positions that are in the batch
+         */
+        void finish(const size_t& begin, const int* packed, const int* phase, int* scores) const;
+
+    public:
+        /**
+         * @brief Constructs an empty batch with room for (at least) `capacity` positions
+         */
+        explicit BatchEvaluator(const size_t& capacity = 0);
+
+        /**
+         * @brief Makes room for (at least) `capacity` positions, keeping the ones already added
+         */
+        void reserve(const size_t& capacity);
+
+        /**
+         * @brief Removes every position, keeping the memory
+         */
+        void clear() { size_ = 0; }
+
+        /**
+         * @brief Appends a copy of the position to the batch
+         */
+        void add(const ChessBoard& board);
+
+        size_t size() const { return size_; }
+
+        /**
+         * @brief Scores every position in the batch, as ChessBoard::evaluate() would (side to move's point of view)
+         * @param scores Receives size() scores, in the order the positions were added
+         */
+        void evaluate(int* scores) const;
+
+        /**
+         * @brief Same as evaluate(), but always on the scalar path (for checking the SIMD one)
+         */
+        void evaluateScalar(int* scores) const;
+
+        /**
+         * @brief Checks whether evaluate() uses the AVX2 kernel (ie. the build defines USE_AVX2)
+         */
+        static bool usesAvx2();
+};
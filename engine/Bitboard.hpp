@@ -0,0 +1,75 @@
+/**
+ * @namespace Bitboards
+ * @brief Defines the 64-bit square set used by the engine, along with the helpers for indexing into it
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/** A set of squares on the 8x8 board, one bit per square.
+ *  Square indices follow the row / column layout used by ChessBoard:
+ *
+ *     7 | 56 57 58 59 60 61 62 63
+ *     6 | 48 49 50 51 52 53 54 55
+ *     ...
+ *     1 |  8  9 10 11 12 13 14 15
+ *     0 |  0  1  2  3  4  5  6  7
+ *       +------------------------
+ *          0  1  2  3  4  5  6  7
+ *
+ *  ie. square = row * 8 + col
+ */
+typedef uint64_t Bitboard;
+
+namespace Bitboards {
+    const int SQUARE_COUNT = 64;
+    const int NO_SQUARE = -1;
+
+    /**
+     * @brief Converts a (row, col) position into a square index
+     * @pre Both row and col lie in [0, 8)
+     */
+    inline int square(const int& row, const int& col) { return (row << 3) | col; }
+
+    /**
+     * @brief Gets the row of a square index
+     */
+    inline int rowOf(const int& sq) { return sq >> 3; }
+
+    /**
+     * @brief Gets the column of a square index
+     */
+    inline int colOf(const int& sq) { return sq & 7; }
+
+    /**
+     * @brief Gets the single-bit Bitboard for a square index
+     */
+    inline Bitboard squareBit(const int& sq) { return Bitboard(1) << sq; }
+
+    /**
+     * @brief Counts the number of squares in the set
+     */
+    inline int popCount(const Bitboard& b) { return __builtin_popcountll(b); }
+
+    /**
+     * @brief Gets the lowest square in the set
+     * @pre b is non-empty
+     */
+    inline int lowestSquare(const Bitboard& b) { return __builtin_ctzll(b); }
+
+    /**
+     * @brief Removes the lowest square from the set and returns it
+     * @pre b is non-empty
+     */
+    inline int popLowest(Bitboard& b) {
+        int sq = __builtin_ctzll(b);
+        b &= b - 1;
+        return sq;
+    }
+
+    /**
+     * @brief Determines whether the set has more than one square in it
+     */
+    inline bool moreThanOne(const Bitboard& b) { return (b & (b - 1)) != 0; }
+}
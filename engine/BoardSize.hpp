@@ -0,0 +1,39 @@
+/**
+ * @struct BoardSize
+ * @brief Compile-time facts about an N x N board (4 <= N <= 32), including the narrowest integer type its line masks fit in
+ *
+ * BOARD_LENGTH, the size of the chessboard, is defined here once; ChessPiece, PieceRules and ChessBoard all take it
+ * from here. The chess engine's bitboards (see Bitboard.hpp) only describe that 8x8 board, but the placement puzzles
+ * work on any size: QueenSolver<N> is instantiated per size and works in BoardSize<N>'s LineMask.
+ *
+ *     LineMask   One bit per row (or column) of the board: uint16_t up to 16, uint32_t up to 32
+ *
+ * There is no per-size cell mask: the solvers only track rows and diagonals, one bit per row of a column, so line
+ * masks are all they need.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+constexpr int MIN_BOARD_LENGTH = 4;
+constexpr int MAX_BOARD_LENGTH = 32;
+
+template <int N>
+struct BoardSize {
+    static_assert(N >= MIN_BOARD_LENGTH && N <= MAX_BOARD_LENGTH, "board sizes run from 4x4 to 32x32");
+
+    static constexpr int LENGTH = N;
+    static constexpr int CELLS = N * N;
+
+    typedef typename std::conditional<(N <= 16), uint16_t, uint32_t>::type LineMask;
+
+    // Every row (or column) of the board
+    static constexpr LineMask FULL_LINE = LineMask(N == 32 ? ~uint32_t(0) : (uint32_t(1) << N) - 1);
+};
+
+// The chessboard, its pieces and the engine are 8x8
+constexpr int BOARD_LENGTH = 8;
+
+static_assert(BoardSize<BOARD_LENGTH>::CELLS <= 64, "the engine's 64-bit bitboards cover the chessboard");
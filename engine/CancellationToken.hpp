@@ -0,0 +1,67 @@
+/**
+ * @class CancellationToken
+ * @brief A shared "stop now" signal for long-running work, raised by cancel() or by passing a deadline
+ *
+ * Copies of a token share one state, so the submitter keeps a copy to cancel() with and the job polls its own copy
+ * with stopRequested(). Stopping is cooperative: work that never polls runs to completion. A default-constructed
+ * token is never raised unless cancel() is called on it (or on a copy).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+class CancellationToken {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+    private:
+        struct State {
+            std::atomic<bool> cancelled;
+            int64_t deadline;            // Clock ticks since its epoch, or NO_DEADLINE
+
+            State(const int64_t& ticks) : cancelled{false}, deadline{ticks} {}
+        };
+
+        static constexpr int64_t NO_DEADLINE = INT64_MAX;
+
+        std::shared_ptr<State> state_;
+
+    public:
+        /**
+         * @brief Constructs a token without a deadline
+         */
+        CancellationToken() : state_{std::make_shared<State>(NO_DEADLINE)} {}
+
+        /**
+         * @brief Constructs a token that is raised at the given time
+         */
+        explicit CancellationToken(const Clock::time_point& deadline)
+            : state_{std::make_shared<State>(deadline.time_since_epoch().count())} {}
+
+        /**
+         * @brief Constructs a token that is raised after the given time from now
+         */
+        static CancellationToken after(const std::chrono::milliseconds& budget) { return CancellationToken(Clock::now() + budget); }
+
+        /**
+         * @brief Raises the token for every copy. Safe to call from any thread.
+         */
+        void cancel() const { state_->cancelled.store(true, std::memory_order_relaxed); }
+
+        /**
+         * @brief Checks whether cancel() has been called or the deadline has passed. Safe to call from any thread.
+         * @note Once the deadline has passed the token counts as cancelled, so later calls skip the clock.
+         */
+        bool stopRequested() const {
+            if (state_->cancelled.load(std::memory_order_relaxed)) { return true; }
+            if (state_->deadline == NO_DEADLINE || Clock::now().time_since_epoch().count() < state_->deadline) { return false; }
+            cancel();
+            return true;
+        }
+
+        bool hasDeadline() const { return state_->deadline != NO_DEADLINE; }
+};
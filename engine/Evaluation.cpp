@@ -0,0 +1,144 @@
+#include "Evaluation.hpp"
+#include "../pieces_module.hpp"
+
+namespace Evaluation {
+    int middlegameTable[PieceCodes::CODE_COUNT][Bitboards::SQUARE_COUNT];
+    int endgameTable[PieceCodes::CODE_COUNT][Bitboards::SQUARE_COUNT];
+    int phaseWeights[PieceCodes::CODE_COUNT];
+    int pieceValues[PIECE_KIND_COUNT];
+}
+
+namespace {
+    // Piece-square tables, written as a diagram from the moving side's point of view: its back row is the last line,
+    // and its King starts on the fifth column from the left. Knights, Bishops, Rooks and Queens use the same table
+    // in both phases.
+    const int PAWN_MIDDLEGAME[64] = {
+          0,   0,   0,   0,   0,   0,   0,   0,
+         50,  50,  50,  50,  50,  50,  50,  50,
+         10,  10,  20,  30,  30,  20,  10,  10,
+          5,   5,  10,  25,  25,  10,   5,   5,
+          0,   0,   0,  20,  20,   0,   0,   0,
+          5,  -5, -10,   0,   0, -10,  -5,   5,
+          5,  10,  10, -20, -20,  10,  10,   5,
+          0,   0,   0,   0,   0,   0,   0,   0
+    };
+    const int PAWN_ENDGAME[64] = {
+          0,   0,   0,   0,   0,   0,   0,   0,
+         80,  80,  80,  80,  80,  80,  80,  80,
+         50,  50,  50,  50,  50,  50,  50,  50,
+         30,  30,  30,  30,  30,  30,  30,  30,
+         20,  20,  20,  20,  20,  20,  20,  20,
+         10,  10,  10,  10,  10,  10,  10,  10,
+         10,  10,  10,  10,  10,  10,  10,  10,
+          0,   0,   0,   0,   0,   0,   0,   0
+    };
+    const int KNIGHT_TABLE[64] = {
+        -50, -40, -30, -30, -30, -30, -40, -50,
+        -40, -20,   0,   0,   0,   0, -20, -40,
+        -30,   0,  10,  15,  15,  10,   0, -30,
+        -30,   5,  15,  20,  20,  15,   5, -30,
+        -30,   0,  15,  20,  20,  15,   0, -30,
+        -30,   5,  10,  15,  15,  10,   5, -30,
+        -40, -20,   0,   5,   5,   0, -20, -40,
+        -50, -40, -30, -30, -30, -30, -40, -50
+    };
+    const int BISHOP_TABLE[64] = {
+        -20, -10, -10, -10, -10, -10, -10, -20,
+        -10,   0,   0,   0,   0,   0,   0, -10,
+        -10,   0,   5,  10,  10,   5,   0, -10,
+        -10,   5,   5,  10,  10,   5,   5, -10,
+        -10,   0,  10,  10,  10,  10,   0, -10,
+        -10,  10,  10,  10,  10,  10,  10, -10,
+        -10,   5,   0,   0,   0,   0,   5, -10,
+        -20, -10, -10, -10, -10, -10, -10, -20
+    };
+    const int ROOK_TABLE[64] = {
+          0,   0,   0,   0,   0,   0,   0,   0,
+          5,  10,  10,  10,  10,  10,  10,   5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+          0,   0,   0,   5,   5,   0,   0,   0
+    };
+    const int QUEEN_TABLE[64] = {
+        -20, -10, -10,  -5,  -5, -10, -10, -20,
+        -10,   0,   0,   0,   0,   0,   0, -10,
+        -10,   0,   5,   5,   5,   5,   0, -10,
+         -5,   0,   5,   5,   5,   5,   0,  -5,
+          0,   0,   5,   5,   5,   5,   0,  -5,
+        -10,   5,   5,   5,   5,   5,   0, -10,
+        -10,   0,   5,   0,   0,   0,   0, -10,
+        -20, -10, -10,  -5,  -5, -10, -10, -20
+    };
+    const int KING_MIDDLEGAME[64] = {
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -20, -30, -30, -40, -40, -30, -30, -20,
+        -10, -20, -20, -20, -20, -20, -20, -10,
+         20,  20,   0,   0,   0,   0,  20,  20,
+         20,  30,  10,   0,   0,  10,  30,  20
+    };
+    const int KING_ENDGAME[64] = {
+        -50, -40, -30, -20, -20, -30, -40, -50,
+        -30, -20, -10,   0,   0, -10, -20, -30,
+        -30, -10,  20,  30,  30,  20, -10, -30,
+        -30, -10,  30,  40,  40,  30, -10, -30,
+        -30, -10,  30,  40,  40,  30, -10, -30,
+        -30, -10,  20,  30,  30,  20, -10, -30,
+        -30, -30,   0,   0,   0,   0, -30, -30,
+        -50, -30, -30, -30, -30, -30, -30, -50
+    };
+
+    const int* const MIDDLEGAME_TABLES[PIECE_KIND_COUNT] = {
+        PAWN_MIDDLEGAME, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, KING_MIDDLEGAME
+    };
+    const int* const ENDGAME_TABLES[PIECE_KIND_COUNT] = {
+        PAWN_ENDGAME, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, KING_ENDGAME
+    };
+    const int PHASE_WEIGHTS[PIECE_KIND_COUNT] = { 0, 1, 1, 2, 4, 0 };
+
+    /**
+     * @brief Gets the diagram index of a square for a side: rows count up from the side's home row, and columns
+     *        are mirrored because the board's column 0 is on the right of the side's diagram
+     */
+    int diagramIndex(const int& side, const int& sq) {
+        int row = Bitboards::rowOf(sq);
+        int relativeRow = (side == PLAYER_ONE) ? row : 7 - row;
+        return (7 - relativeRow) * 8 + (7 - Bitboards::colOf(sq));
+    }
+
+    // Builds the tables before main() runs
+    struct Initializer {
+        Initializer() { Evaluation::init(); }
+    } initializer;
+}
+
+void Evaluation::init() {
+    static bool initialized = false;
+    if (initialized) { return; }
+    initialized = true;
+
+    pieceValues[PAWN_KIND] = 100 * Pawn().size();
+    pieceValues[KNIGHT_KIND] = 100 * Knight().size();
+    pieceValues[BISHOP_KIND] = 100 * Bishop().size();
+    pieceValues[ROOK_KIND] = 100 * Rook().size();
+    pieceValues[QUEEN_KIND] = 100 * Queen().size();
+    pieceValues[KING_KIND] = 100 * King().size();
+
+    for (int side = 0; side < SIDE_COUNT; side++) {
+        int sign = (side == PLAYER_ONE) ? 1 : -1;
+        for (int kind = 0; kind < PIECE_KIND_COUNT; kind++) {
+            int code = PieceCodes::make(side, kind);
+            phaseWeights[code] = PHASE_WEIGHTS[kind];
+            for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+                int index = diagramIndex(side, sq);
+                middlegameTable[code][sq] = sign * (pieceValues[kind] + MIDDLEGAME_TABLES[kind][index]);
+                endgameTable[code][sq] = sign * (pieceValues[kind] + ENDGAME_TABLES[kind][index]);
+            }
+        }
+    }
+}
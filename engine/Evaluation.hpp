@@ -0,0 +1,47 @@
+/**
+ * @namespace Evaluation
+ * @brief Tapered material + piece-square-table evaluation terms, precomputed per (piece code, square)
+ *
+ * Every piece contributes a middlegame and an endgame score that depend only on its kind, side and square, so a
+ * position's totals are sums that a move updates with a few additions (see ChessBoard::evaluate()). Material is
+ * 100 x ChessPiece::size() in both phases; the piece-square tables add positional bonuses on top. The final score
+ * blends the two totals by the game phase, which falls from PHASE_MAX (all minor and major pieces on the board)
+ * to 0 (bare Kings and pawns).
+ *
+ * Table entries are signed from PLAYER_ONE's point of view: PLAYER_TWO's pieces count negatively.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "Bitboard.hpp"
+#include "Types.hpp"
+
+namespace Evaluation {
+    const int PHASE_MAX = 24;
+
+    // Lookup tables, filled in by init()
+    extern int middlegameTable[PieceCodes::CODE_COUNT][Bitboards::SQUARE_COUNT];
+    extern int endgameTable[PieceCodes::CODE_COUNT][Bitboards::SQUARE_COUNT];
+    extern int phaseWeights[PieceCodes::CODE_COUNT];     // Knights and Bishops 1, Rooks 2, Queens 4
+    extern int pieceValues[PIECE_KIND_COUNT];            // 100 x ChessPiece::size()
+
+    /**
+     * @brief Fills in the tables. Safe to call more than once.
+     * @note This runs automatically during static initialization, so callers never need to call it themselves.
+     */
+    void init();
+
+    inline int middlegame(const uint8_t& code, const int& sq) { return middlegameTable[code][sq]; }
+    inline int endgame(const uint8_t& code, const int& sq) { return endgameTable[code][sq]; }
+    inline int phase(const uint8_t& code) { return phaseWeights[code]; }
+    inline int pieceValue(const int& kind) { return pieceValues[kind]; }
+
+    /**
+     * @brief Interpolates between the middlegame and endgame scores by the game phase (capped at PHASE_MAX)
+     */
+    inline int blend(const int& middlegameScore, const int& endgameScore, const int& gamePhase) {
+        int weight = gamePhase < PHASE_MAX ? gamePhase : PHASE_MAX;
+        return (middlegameScore * weight + endgameScore * (PHASE_MAX - weight)) / PHASE_MAX;
+    }
+}
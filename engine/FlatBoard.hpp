@@ -0,0 +1,113 @@
+/**
+ * @class FlatBoard
+ * @brief An N x N board of characters stored row by row in one std::array: a fixed-size value type for the
+ *        placement puzzles' boards
+ *
+ * ChessBoard::CharacterBoard is a vector of row vectors, so every board costs N + 1 heap allocations and every cell
+ * access goes through a row pointer. A FlatBoard is one block of N * N chars and allocates nothing: cell (row, col) is
+ * cell row * N + col, copying is a memcpy, equality and ordering are a single memcmp, and hash() reads the cells eight
+ * at a time. Transform, ChessBoard (as ChessBoard::FlatCharacterBoard) and QueenSolver<N> have overloads that take or
+ * return FlatBoards; fromCharacterBoard() and toCharacterBoard() convert to and from the legacy type.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+template <int N>
+class FlatBoard {
+    static_assert(N >= 1, "a board has at least one cell");
+
+    public:
+        typedef std::vector<std::vector<char>> CharacterBoard;
+
+        static constexpr int LENGTH = N;
+        static constexpr int CELLS = N * N;
+
+        // The character of an empty cell, as in CharacterBoard ('Q' marks a queen)
+        static constexpr char EMPTY = '*';
+
+    private:
+        std::array<char, CELLS> cells_;
+
+        static uint64_t mix(uint64_t h) {
+            h *= 0x9E3779B97F4A7C15ULL;
+            return h ^ (h >> 29);
+        }
+
+    public:
+        /**
+         * @brief Builds an empty board
+         */
+        FlatBoard() { cells_.fill(EMPTY); }
+
+        /**
+         * @brief Builds a board with every cell set to `fill`
+         */
+        explicit FlatBoard(const char& fill) { cells_.fill(fill); }
+
+        char& operator()(const int& row, const int& col) { return cells_[row * N + col]; }
+        const char& operator()(const int& row, const int& col) const { return cells_[row * N + col]; }
+
+        char* data() { return cells_.data(); }
+        const char* data() const { return cells_.data(); }
+
+        /**
+         * @brief Copies a CharacterBoard, one row at a time
+         * @pre The board has N rows of N cells
+         */
+        static FlatBoard fromCharacterBoard(const CharacterBoard& board) {
+            FlatBoard flat;
+            for (int row = 0; row < N; row++) { std::memcpy(flat.cells_.data() + row * N, board[row].data(), N); }
+            return flat;
+        }
+
+        /**
+         * @brief Copies the board into a CharacterBoard, for the callers that still take one
+         */
+        CharacterBoard toCharacterBoard() const {
+            CharacterBoard board(N);
+            for (int row = 0; row < N; row++) { board[row].assign(cells_.data() + row * N, cells_.data() + (row + 1) * N); }
+            return board;
+        }
+
+        bool operator==(const FlatBoard& other) const { return std::memcmp(cells_.data(), other.cells_.data(), CELLS) == 0; }
+        bool operator!=(const FlatBoard& other) const { return !(*this == other); }
+
+        /**
+         * @brief Orders boards by their cells, row by row, as memcmp does
+         * @note ChessBoard::groupSimilarBoards() keys each group by the least of its boards' transformations
+         */
+        bool operator<(const FlatBoard& other) const { return std::memcmp(cells_.data(), other.cells_.data(), CELLS) < 0; }
+
+        /**
+         * @brief Hashes the cells a 64-bit word at a time (the last word zero-padded)
+         */
+        uint64_t hash() const {
+            uint64_t h = CELLS;
+            int i = 0;
+            for (; i + 8 <= CELLS; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, cells_.data() + i, 8);
+                h = mix(h ^ word);
+            }
+            if (i < CELLS) {
+                uint64_t word = 0;
+                std::memcpy(&word, cells_.data() + i, CELLS - i);
+                h = mix(h ^ word);
+            }
+            return h;
+        }
+};
+
+namespace std {
+    template <int N>
+    struct hash<FlatBoard<N>> {
+        size_t operator()(const FlatBoard<N>& board) const { return size_t(board.hash()); }
+    };
+}
@@ -0,0 +1,173 @@
+#include "Instrumentation.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace Instrumentation {
+    thread_local ThreadCounters* current = nullptr;
+}
+
+namespace {
+    using namespace Instrumentation;
+
+    /**
+     * @brief Every block handed out, and the totals of the threads that have finished
+     */
+    struct Registry {
+        std::mutex lock;
+        std::vector<ThreadCounters*> live;
+        std::vector<ThreadCounters*> spare;     // Blocks of finished threads, zeroed, ready for the next thread
+        uint64_t finishedCounters[COUNTER_COUNT] = {};
+        uint64_t finishedTimerCalls[TIMER_COUNT] = {};
+        uint64_t finishedTimerNanoseconds[TIMER_COUNT] = {};
+        int threads = 0;
+    };
+
+    /**
+     * @brief The registry is never destroyed, so threads still exiting after main() returns can always retire their blocks
+     */
+    Registry& registry() {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    void clear(ThreadCounters& counters) {
+        for (auto& value : counters.counters) { value.store(0, std::memory_order_relaxed); }
+        for (auto& value : counters.timerCalls) { value.store(0, std::memory_order_relaxed); }
+        for (auto& value : counters.timerNanoseconds) { value.store(0, std::memory_order_relaxed); }
+    }
+
+    /**
+     * @brief Owned by each registered thread; retires the thread's block when the thread exits
+     */
+    struct Registration {
+        ThreadCounters* counters = nullptr;
+
+        ~Registration() {
+            if (!counters) { return; }
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> guard(shared.lock);
+            for (int c = 0; c < COUNTER_COUNT; c++) { shared.finishedCounters[c] += counters->counters[c].load(std::memory_order_relaxed); }
+            for (int t = 0; t < TIMER_COUNT; t++) {
+                shared.finishedTimerCalls[t] += counters->timerCalls[t].load(std::memory_order_relaxed);
+                shared.finishedTimerNanoseconds[t] += counters->timerNanoseconds[t].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < shared.live.size(); i++) {
+                if (shared.live[i] == counters) {
+                    shared.live[i] = shared.live.back();
+                    shared.live.pop_back();
+                    break;
+                }
+            }
+            clear(*counters);
+            shared.spare.push_back(counters);
+            Instrumentation::current = nullptr;
+        }
+    };
+
+    thread_local Registration registration;
+
+    const char* const COUNTER_NAMES[COUNTER_COUNT] = {
+        "solver_nodes", "can_move_calls", "reachable_queries", "piece_allocations", "board_transforms", "grouping_comparisons"
+    };
+
+    const char* const TIMER_NAMES[TIMER_COUNT] = {
+        "find_all_queen_placements", "get_all_transformations", "group_similar_boards"
+    };
+
+    bool fail(std::string* error, const std::string& message) {
+        if (error) { *error = message; }
+        return false;
+    }
+}
+
+/**
+ * @brief Gives the calling thread a block of counters
+ * @note The block is folded into the finished-thread totals, and reused, when the thread exits
+ */
+ThreadCounters& Instrumentation::registerThread() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    ThreadCounters* counters = nullptr;
+    if (!shared.spare.empty()) {
+        counters = shared.spare.back();
+        shared.spare.pop_back();
+    } else {
+        counters = new ThreadCounters();
+        clear(*counters);
+    }
+    shared.live.push_back(counters);
+    shared.threads++;
+    registration.counters = counters;
+    current = counters;
+    return *counters;
+}
+
+/**
+ * @brief Adds up the counters of every thread
+ */
+Snapshot Instrumentation::snapshot() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    Snapshot result;
+    std::memcpy(result.counters, shared.finishedCounters, sizeof(result.counters));
+    std::memcpy(result.timerCalls, shared.finishedTimerCalls, sizeof(result.timerCalls));
+    std::memcpy(result.timerNanoseconds, shared.finishedTimerNanoseconds, sizeof(result.timerNanoseconds));
+    for (const ThreadCounters* counters : shared.live) {
+        for (int c = 0; c < COUNTER_COUNT; c++) { result.counters[c] += counters->counters[c].load(std::memory_order_relaxed); }
+        for (int t = 0; t < TIMER_COUNT; t++) {
+            result.timerCalls[t] += counters->timerCalls[t].load(std::memory_order_relaxed);
+            result.timerNanoseconds[t] += counters->timerNanoseconds[t].load(std::memory_order_relaxed);
+        }
+    }
+    result.threads = shared.threads;
+    return result;
+}
+
+/**
+ * @brief Sets every counter and timer of every thread back to 0
+ */
+void Instrumentation::reset() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    std::memset(shared.finishedCounters, 0, sizeof(shared.finishedCounters));
+    std::memset(shared.finishedTimerCalls, 0, sizeof(shared.finishedTimerCalls));
+    std::memset(shared.finishedTimerNanoseconds, 0, sizeof(shared.finishedTimerNanoseconds));
+    for (ThreadCounters* counters : shared.live) { clear(*counters); }
+    shared.threads = int(shared.live.size());
+}
+
+const char* Instrumentation::counterName(const Counter& counter) { return COUNTER_NAMES[counter]; }
+
+const char* Instrumentation::timerName(const Timer& timer) { return TIMER_NAMES[timer]; }
+
+/**
+ * @brief Formats a snapshot as a JSON object (see the header for its layout)
+ */
+std::string Instrumentation::toJson(const Snapshot& snapshot) {
+    std::string json = std::string("{\"enabled\": ") + (ENABLED ? "true" : "false") +
+                       ", \"threads\": " + std::to_string(snapshot.threads) + ", \"counters\": {";
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        json += std::string(c ? ", " : "") + "\"" + COUNTER_NAMES[c] + "\": " + std::to_string(snapshot.counters[c]);
+    }
+    json += "}, \"timers\": {";
+    for (int t = 0; t < TIMER_COUNT; t++) {
+        json += std::string(t ? ", " : "") + "\"" + TIMER_NAMES[t] + "\": {\"calls\": " + std::to_string(snapshot.timerCalls[t]) +
+                ", \"nanoseconds\": " + std::to_string(snapshot.timerNanoseconds[t]) + "}";
+    }
+    return json + "}}";
+}
+
+/**
+ * @brief Writes the JSON of a fresh snapshot to a file
+ */
+bool Instrumentation::dumpJson(const std::string& path, std::string* error) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) { return fail(error, "cannot create " + path + ": " + std::strerror(errno)); }
+    std::string json = toJson(snapshot()) + "\n";
+    bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    ok = (std::fclose(file) == 0) && ok;
+    return ok || fail(error, "cannot write " + path);
+}
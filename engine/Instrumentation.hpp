@@ -0,0 +1,156 @@
+/**
+ * @namespace Instrumentation
+ * @brief Counters and scoped timers for the library's hot paths, compiled in only when INSTRUMENTATION is defined
+ *
+ * Build with INSTRUMENT=1 to turn them on. Every thread counts into its own block of counters, padded to a cache
+ * line so that threads never share one, and only that thread writes to it; snapshot() adds the blocks of all live
+ * threads to the totals left behind by threads that have finished.
+ *
+ * Hot paths use the macros below rather than the functions, so that a normal build compiles them to nothing:
+ *     INSTRUMENT_COUNT(counter)      Adds one to a counter
+ *     INSTRUMENT_ADD(counter, n)     Adds n to a counter
+ *     INSTRUMENT_SCOPE(timer)        Times the rest of the enclosing scope
+ *
+ * snapshot(), reset() and the JSON output exist in both builds; without instrumentation every value reads 0 and
+ * ENABLED is false.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Instrumentation {
+    #ifdef INSTRUMENTATION
+    constexpr bool ENABLED = true;
+    #else
+    constexpr bool ENABLED = false;
+    #endif
+
+    enum Counter {
+        SOLVER_NODES,          // queenHelper() calls
+        CAN_MOVE_CALLS,        // Single-cell movement rule checks (canMove())
+        REACHABLE_QUERIES,     // Whole-board movement rule checks (reachableSquares())
+        PIECE_ALLOCATIONS,     // ChessPiece objects constructed
+        BOARD_TRANSFORMS,      // Matrices produced by Transform::rotate() and the flips
+        GROUPING_COMPARISONS,  // Board comparisons made by groupSimilarBoards() (flat boards are grouped by hash instead)
+        COUNTER_COUNT
+    };
+
+    enum Timer {
+        QUEEN_PLACEMENTS,      // findAllQueenPlacements() and findOneQueenPlacement()
+        TRANSFORMATIONS,       // getAllTransformations()
+        GROUPING,              // groupSimilarBoards()
+        TIMER_COUNT
+    };
+
+    /**
+     * @brief Totals over every thread at one point in time
+     */
+    struct Snapshot {
+        uint64_t counters[COUNTER_COUNT];
+        uint64_t timerCalls[TIMER_COUNT];
+        uint64_t timerNanoseconds[TIMER_COUNT];
+        int threads;                            // Threads that have counted anything, live or finished
+    };
+
+    /**
+     * @brief One thread's counters. alignas pads it to whole cache lines so neighbouring blocks never share one.
+     * @note Only the owning thread writes, so a relaxed load and store is enough; readers may see a count that is a
+     *       few increments behind.
+     */
+    struct alignas(64) ThreadCounters {
+        std::atomic<uint64_t> counters[COUNTER_COUNT];
+        std::atomic<uint64_t> timerCalls[TIMER_COUNT];
+        std::atomic<uint64_t> timerNanoseconds[TIMER_COUNT];
+    };
+
+    extern thread_local ThreadCounters* current;  // The calling thread's block, once registered
+
+    /**
+     * @brief Gives the calling thread a block of counters
+     * @note The block is folded into the finished-thread totals, and reused, when the thread exits
+     */
+    ThreadCounters& registerThread();
+
+    /**
+     * @brief Gets the calling thread's counters, registering them on the thread's first call
+     */
+    inline ThreadCounters& local() { return current ? *current : registerThread(); }
+
+    /**
+     * @brief Adds to one of the calling thread's counters
+     */
+    inline void add(std::atomic<uint64_t>& slot, const uint64_t& amount) {
+        slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    inline void count(const Counter& counter, const uint64_t& amount = 1) { add(local().counters[counter], amount); }
+
+    /**
+     * @brief Times its own lifetime and adds it to a timer of the constructing thread
+     */
+    class ScopedTimer {
+        private:
+            Timer timer_;
+            std::chrono::steady_clock::time_point start_;
+
+        public:
+            explicit ScopedTimer(const Timer& timer) : timer_{timer}, start_{std::chrono::steady_clock::now()} {}
+
+            ~ScopedTimer() {
+                ThreadCounters& counters = local();
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                add(counters.timerCalls[timer_], 1);
+                add(counters.timerNanoseconds[timer_], uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+
+    /**
+     * @brief Adds up the counters of every thread
+     */
+    Snapshot snapshot();
+
+    /**
+     * @brief Sets every counter and timer of every thread back to 0
+     * @note Threads counting at the same time may lose the increments they make while the reset runs
+     */
+    void reset();
+
+    /**
+     * @brief Gets the name a counter or timer has in the JSON output, eg. "solver_nodes"
+     */
+    const char* counterName(const Counter& counter);
+    const char* timerName(const Timer& timer);
+
+    /**
+     * @brief Formats a snapshot as a JSON object:
+     *        {"enabled": true, "threads": 1, "counters": {"solver_nodes": 2057, ...},
+     *         "timers": {"find_all_queen_placements": {"calls": 1, "nanoseconds": 1200000}, ...}}
+     */
+    std::string toJson(const Snapshot& snapshot);
+
+    /**
+     * @brief Writes the JSON of a fresh snapshot to a file
+     * @return False (with an explanation in `error`) if the file could not be written
+     */
+    bool dumpJson(const std::string& path, std::string* error = nullptr);
+}
+
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+
+#ifdef INSTRUMENTATION
+#define INSTRUMENT_COUNT(counter) Instrumentation::count(Instrumentation::counter)
+#define INSTRUMENT_ADD(counter, n) Instrumentation::count(Instrumentation::counter, (n))
+#define INSTRUMENT_SCOPE(timer) Instrumentation::ScopedTimer INSTRUMENT_CONCAT(instrumentTimer_, __LINE__)(Instrumentation::timer)
+#else
+#define INSTRUMENT_COUNT(counter) ((void)0)
+#define INSTRUMENT_ADD(counter, n) ((void)0)
+#define INSTRUMENT_SCOPE(timer) ((void)0)
+#endif
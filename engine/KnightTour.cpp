@@ -0,0 +1,415 @@
+#include "KnightTour.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include "Prng.hpp"
+
+namespace {
+    // Same jumps, in the same order, as the engine's knight attack table
+    const int KNIGHT_JUMPS[8][2] = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+
+    const int WALK_ATTEMPTS = 8;           // Warnsdorff walks tried per start: one deterministic, then randomized ones
+    const int WALK_ROTATIONS = 256;        // Rotations a stuck walk may try before it gives up, plus...
+    const int ROTATIONS_PER_SQUARE = 8;    // ...this many per square between its end and the square it heads for
+    const size_t PREFIXES_PER_THREAD = 16; // Work items to expand per worker, so long and short subtrees balance out
+    const int MAX_PREFIX_LENGTH = 10;
+    const int64_t EXHAUSTIVE_NODES = 1 << 22; // Squares findTour()'s exhaustive fallback may visit before it gives up
+
+    /**
+     * @brief Checks whether a tour can no longer be finished from `current`, with `visited` squares behind it
+     * @note The rest of the tour runs through every unvisited square, entering and leaving each one except the last
+     *       (and, for a closed tour, leaving the last one too, for the start). So every unvisited square needs two
+     *       links among the unvisited squares, `current` and (closed tours) the start, except one at most; and one
+     *       with no unvisited neighbors at all can only be entered from `current`, as the very last square.
+     */
+    bool deadEnd(const uint64_t* masks, const int& squares, const int& current, const uint64_t& visited, const int& start, const bool& closed) {
+        uint64_t unvisited = ~visited & (squares == 64 ? ~uint64_t(0) : (uint64_t(1) << squares) - 1);
+        int ends = 0;
+        for (uint64_t rest = unvisited; rest; rest &= rest - 1) {
+            int sq = __builtin_ctzll(rest);
+            int links = __builtin_popcountll(masks[sq] & unvisited) + int((masks[current] >> sq) & 1);
+            if (closed) { links += int((masks[start] >> sq) & 1); }
+            if (links < 2 && ++ends > (closed ? 0 : 1)) { return true; }
+            if (!(masks[sq] & unvisited) && (unvisited & (unvisited - 1))) { return true; }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Exhaustive search for a first open tour, trying the neighbors with the fewest unvisited neighbors first
+     * @param path Holds the squares visited so far, and receives the tour
+     * @param budget Squares left to visit; the search gives up when it runs out
+     */
+    bool firstTour(const uint64_t* masks, const int& squares, const int& current, const uint64_t& visited, const int& depth,
+                   uint8_t* path, int64_t& budget) {
+        if (depth == squares) { return true; }
+        if (--budget < 0 || deadEnd(masks, squares, current, visited, 0, false)) { return false; }
+
+        uint64_t open = masks[current] & ~visited;
+        int candidates[8];
+        int exits[8];
+        int count = 0;
+        for (; open; open &= open - 1) {
+            int sq = __builtin_ctzll(open);
+            int sqExits = __builtin_popcountll(masks[sq] & ~visited);
+
+            int at = count++;
+            for (; at > 0 && exits[at - 1] > sqExits; at--) {
+                candidates[at] = candidates[at - 1];
+                exits[at] = exits[at - 1];
+            }
+            candidates[at] = sq;
+            exits[at] = sqExits;
+        }
+
+        for (int i = 0; i < count; i++) {
+            path[depth] = uint8_t(candidates[i]);
+            if (firstTour(masks, squares, candidates[i], visited | (uint64_t(1) << candidates[i]), depth + 1, path, budget)) { return true; }
+        }
+        return false;
+    }
+
+    /**
+     * @brief One worker's exhaustive search. Record also keeps the path and reports every tour to the visitor.
+     */
+    template <bool Record>
+    struct TourSearch {
+        const uint64_t* masks;
+        int squares;
+        int start;
+        bool closed;
+        const KnightTour::TourVisitor* visit;
+        std::mutex* visitLock;
+        uint8_t path[KnightTour::MAX_ENUMERATION_SQUARES];
+
+        /**
+         * @brief Counts the ways to finish a tour from `current`, the depth-th square visited
+         */
+        uint64_t count(const int& current, const uint64_t& visited, const int& depth) {
+            if (depth == squares) {
+                if (closed && !(masks[current] & (uint64_t(1) << start))) { return 0; }
+                if constexpr (Record) {
+                    std::vector<uint8_t> tour(path, path + squares);
+                    std::lock_guard<std::mutex> guard(*visitLock);
+                    (*visit)(tour);
+                }
+                return 1;
+            }
+
+            // A closed tour has to end next to the start
+            if (closed && !(masks[start] & ~visited)) { return 0; }
+            if (deadEnd(masks, squares, current, visited, start, closed)) { return 0; }
+
+            uint64_t tours = 0;
+            uint64_t open = masks[current] & ~visited;
+            for (; open; open &= open - 1) {
+                int next = __builtin_ctzll(open);
+                if constexpr (Record) { path[depth] = uint8_t(next); }
+                tours += count(next, visited | (uint64_t(1) << next), depth + 1);
+            }
+            return tours;
+        }
+    };
+
+    /**
+     * @brief Each worker takes path prefixes off the shared queue until it is empty, and adds up its tours
+     */
+    template <bool Record>
+    uint64_t runWorkers(const std::vector<std::vector<uint8_t>>& prefixes, const uint64_t* masks, const int& squares,
+                        const int& start, const bool& closed, const int& threads, const KnightTour::TourVisitor* visit) {
+        std::atomic<size_t> next{0};
+        std::atomic<uint64_t> total{0};
+        std::mutex visitLock;
+
+        auto worker = [&]() {
+            TourSearch<Record> search;
+            search.masks = masks;
+            search.squares = squares;
+            search.start = start;
+            search.closed = closed;
+            search.visit = visit;
+            search.visitLock = &visitLock;
+
+            uint64_t tours = 0;
+            for (size_t i = next.fetch_add(1); i < prefixes.size(); i = next.fetch_add(1)) {
+                const std::vector<uint8_t>& prefix = prefixes[i];
+                uint64_t visited = 0;
+                for (size_t j = 0; j < prefix.size(); j++) {
+                    search.path[j] = prefix[j];
+                    visited |= uint64_t(1) << prefix[j];
+                }
+                tours += search.count(prefix.back(), visited, int(prefix.size()));
+            }
+            total.fetch_add(tours);
+        };
+
+        std::vector<std::thread> pool;
+        for (int i = 1; i < threads; i++) { pool.emplace_back(worker); }
+        worker();  // The calling thread works too
+        for (size_t i = 0; i < pool.size(); i++) { pool[i].join(); }
+
+        return total.load();
+    }
+}
+
+/**
+ * @brief Builds the knight move graph of a rows x columns board
+ * @param rows The number of rows. Values below 1 are treated as 1.
+ * @param columns The number of columns. Values below 1 are treated as 1.
+ */
+KnightTour::KnightTour(const int& rows, const int& columns)
+    : rows_{rows < 1 ? 1 : rows}, columns_{columns < 1 ? 1 : columns} {
+    firstNeighbor_.reserve(size_t(squares()) + 1);
+    neighbors_.reserve(size_t(squares()) * 8);
+    for (int row = 0; row < rows_; row++) {
+        for (int col = 0; col < columns_; col++) {
+            firstNeighbor_.push_back(uint32_t(neighbors_.size()));
+            for (const int* jump : KNIGHT_JUMPS) {
+                int toRow = row + jump[0];
+                int toCol = col + jump[1];
+                if (toRow >= 0 && toRow < rows_ && toCol >= 0 && toCol < columns_) {
+                    neighbors_.push_back(uint32_t(square(toRow, toCol)));
+                }
+            }
+        }
+    }
+    firstNeighbor_.push_back(uint32_t(neighbors_.size()));
+
+    if (squares() <= MAX_ENUMERATION_SQUARES) {
+        neighborMasks_.assign(squares(), 0);
+        for (int sq = 0; sq < squares(); sq++) {
+            for (int i = 0; i < degree(sq); i++) { neighborMasks_[sq] |= uint64_t(1) << neighbors(sq)[i]; }
+        }
+    }
+}
+
+/**
+ * @brief Checks that `tour` visits every square exactly once, one knight move at a time
+ * @param closed Also require a knight move from the last square back to the first
+ */
+bool KnightTour::isTour(const std::vector<uint32_t>& tour, const bool& closed) const {
+    if (int(tour.size()) != squares()) { return false; }
+
+    auto adjacent = [this](const uint32_t& from, const uint32_t& to) {
+        for (int i = 0; i < degree(int(from)); i++) {
+            if (neighbors(int(from))[i] == to) { return true; }
+        }
+        return false;
+    };
+
+    std::vector<char> seen(squares(), 0);
+    for (size_t i = 0; i < tour.size(); i++) {
+        if (tour[i] >= uint32_t(squares()) || seen[tour[i]]) { return false; }
+        seen[tour[i]] = 1;
+        if (i > 0 && !adjacent(tour[i - 1], tour[i])) { return false; }
+    }
+    return !closed || adjacent(tour.back(), tour.front());
+}
+
+/**
+ * @brief Runs one Warnsdorff walk from `start`, rotating the path whenever its end gets stuck
+ * @param seed Seeds the final tie-break and the choice of rotations, or 0 to break remaining ties by distance from
+ *        the centre
+ * @return True if the walk visited every square
+ * @note A rotation keeps the start and the visited squares: if the end e is a knight move from t[i] on the path
+ *       t[0] .. t[k - 1], then t[0] .. t[i], t[k - 1], t[k - 2] .. t[i + 1] is a path too, ending on t[i + 1]. Walks
+ *       that get stuck near unvisited squares, as Warnsdorff walks from the middle of large boards do, carry on from
+ *       the new end instead of starting over.
+ */
+bool KnightTour::walk(const int& start, const uint64_t& seed, std::vector<uint32_t>& tour) const {
+    std::vector<uint8_t> exits(squares());  // Unvisited neighbors of each square
+    for (int sq = 0; sq < squares(); sq++) { exits[sq] = uint8_t(degree(sq)); }
+    std::vector<char> visited(squares(), 0);
+    std::vector<uint32_t> position(squares());  // Index of each visited square in the tour
+    Prng random(seed);
+
+    auto enter = [&](const uint32_t& sq) {
+        visited[sq] = 1;
+        position[sq] = uint32_t(tour.size());
+        tour.push_back(sq);
+        for (int i = 0; i < degree(int(sq)); i++) { exits[neighbors(int(sq))[i]]--; }
+    };
+
+    // Larger is better: twice the distance from the centre, squared (an integer on even-sized boards too), or random
+    auto tieBreak = [&](const uint32_t& sq) {
+        if (seed) { return int64_t(random.next() >> 1); }
+        int64_t dy = 2 * int64_t(sq / uint32_t(columns_)) - (rows_ - 1);
+        int64_t dx = 2 * int64_t(sq % uint32_t(columns_)) - (columns_ - 1);
+        return dy * dy + dx * dx;
+    };
+
+    // The best unvisited neighbor of `current`: fewest exits, then fewest unvisited squares two jumps on, then the
+    // tie-break. False if every neighbor is visited.
+    auto choose = [&](const uint32_t& current, uint32_t& best) {
+        bool found = false;
+        int bestExits = 0;
+        int bestOnward = 0;
+        int64_t bestTie = 0;
+        for (int i = 0; i < degree(int(current)); i++) {
+            uint32_t sq = neighbors(int(current))[i];
+            if (visited[sq]) { continue; }
+
+            int onward = 0;
+            for (int j = 0; j < degree(int(sq)); j++) {
+                uint32_t beyond = neighbors(int(sq))[j];
+                if (!visited[beyond]) { onward += exits[beyond]; }
+            }
+            int64_t tie = tieBreak(sq);
+            if (!found || exits[sq] < bestExits || (exits[sq] == bestExits &&
+                (onward < bestOnward || (onward == bestOnward && tie > bestTie)))) {
+                found = true;
+                best = sq;
+                bestExits = exits[sq];
+                bestOnward = onward;
+                bestTie = tie;
+            }
+        }
+        return found;
+    };
+
+    // Reverses the tour after position `after`
+    auto rotate = [&](const uint32_t& after) {
+        std::reverse(tour.begin() + after + 1, tour.end());
+        for (size_t i = after + 1; i < tour.size(); i++) { position[tour[i]] = uint32_t(i); }
+    };
+
+    auto distance = [this](const uint32_t& from, const uint32_t& to) {
+        int64_t dy = int64_t(from / uint32_t(columns_)) - int64_t(to / uint32_t(columns_));
+        int64_t dx = int64_t(from % uint32_t(columns_)) - int64_t(to % uint32_t(columns_));
+        return dy * dy + dx * dx;
+    };
+
+    auto color = [this](const uint32_t& sq) { return (sq / uint32_t(columns_) + sq % uint32_t(columns_)) % 2; };
+
+    // Rotates the tour until its end has an unvisited neighbor. Each rotation moves the end two jumps, so it is
+    // steered toward the neighbors of the nearest unvisited square it can reach, with an occasional random rotation
+    // to get out of loops. Two jumps never change the end's color, so that square has to be of the other color.
+    auto unstick = [&]() {
+        uint32_t target = 0;
+        int64_t nearest = -1;
+        for (int sq = 0; sq < squares(); sq++) {
+            if (!visited[sq] && color(uint32_t(sq)) != color(tour.back()) && (nearest < 0 || distance(uint32_t(sq), tour.back()) < nearest)) {
+                target = uint32_t(sq);
+                nearest = distance(uint32_t(sq), tour.back());
+            }
+        }
+
+        if (nearest < 0 || degree(int(target)) == 0) { return false; }
+        int rotations = WALK_ROTATIONS + ROTATIONS_PER_SQUARE * int(std::sqrt(double(nearest)));
+        auto away = [&](const uint32_t& sq) {
+            int64_t closest = distance(sq, neighbors(int(target))[0]);
+            for (int i = 1; i < degree(int(target)); i++) { closest = std::min(closest, distance(sq, neighbors(int(target))[i])); }
+            return closest;
+        };
+
+        for (int attempt = 0; attempt < rotations; attempt++) {
+            uint32_t pivots[8];
+            int count = 0;
+            for (int i = 0; i < degree(int(tour.back())); i++) {
+                uint32_t sq = neighbors(int(tour.back()))[i];
+                if (visited[sq] && position[sq] + 2 < tour.size()) { pivots[count++] = position[sq]; }
+            }
+            if (count == 0) { return false; }
+
+            int best = 0;
+            for (int i = 0; i < count; i++) {
+                if (exits[tour[pivots[i] + 1]] > 0) {
+                    rotate(pivots[i]);
+                    return true;
+                }
+                if (away(tour[pivots[i] + 1]) < away(tour[pivots[best] + 1])) { best = i; }
+            }
+            rotate(pivots[random.next() % 8 == 0 ? int(random.next() % uint32_t(count)) : best]);
+        }
+        return false;
+    };
+
+    tour.clear();
+    enter(uint32_t(start));
+    uint32_t next = 0;
+    while (int(tour.size()) < squares()) {
+        if (!choose(tour.back(), next)) {
+            if (!unstick()) { return false; }
+            choose(tour.back(), next);
+        }
+        enter(next);
+    }
+    return true;
+}
+
+/**
+ * @brief Finds one open tour starting on `start` by Warnsdorff's rule
+ * @param tour Receives the squares in visiting order, or is left empty if no tour was found
+ * @return True if a tour was found
+ * @note On boards with an odd number of squares, tours can only start on the squares of the corners' color (there is
+ *       one more of those, and the knight changes color at every jump), so the others are rejected straight away.
+ *       Boards of up to MAX_ENUMERATION_SQUARES squares fall back to an exhaustive search, which finds the tours the
+ *       walks miss; it gives up after EXHAUSTIVE_NODES squares, since proving that a square starts no tour can take
+ *       much longer (eg. on 4 x n boards, where only half the squares start one).
+ */
+bool KnightTour::findTour(const int& start, std::vector<uint32_t>& tour) const {
+    tour.clear();
+    if (start < 0 || start >= squares()) { return false; }
+    if (squares() % 2 == 1 && (start / columns_ + start % columns_) % 2 == 1) { return false; }
+
+    for (int attempt = 0; attempt < WALK_ATTEMPTS; attempt++) {
+        if (walk(start, uint64_t(attempt), tour)) { return true; }
+    }
+    tour.clear();
+    if (squares() > MAX_ENUMERATION_SQUARES) { return false; }
+
+    uint8_t path[MAX_ENUMERATION_SQUARES];
+    path[0] = uint8_t(start);
+    int64_t budget = EXHAUSTIVE_NODES;
+    if (!firstTour(neighborMasks_.data(), squares(), start, uint64_t(1) << start, 1, path, budget)) { return false; }
+    tour.assign(path, path + squares());
+    return true;
+}
+
+/**
+ * @brief Counts the tours starting on `start`
+ * @param closed Count only closed tours (whose last square is a knight move from the first). Each closed tour
+ *        is counted once per direction.
+ * @param threads The number of worker threads. Values below 1 are treated as 1.
+ * @return The number of tours, or 0 if the board has more than MAX_ENUMERATION_SQUARES squares
+ */
+uint64_t KnightTour::countTours(const int& start, const bool& closed, const int& threads) const {
+    return search(start, closed, threads, nullptr);
+}
+
+/**
+ * @brief Counts the tours starting on `start` and passes each one to `visit`
+ * @param visit Called once per tour, from the worker threads, but never from two at a time
+ * @return The number of tours, or 0 if the board has more than MAX_ENUMERATION_SQUARES squares
+ */
+uint64_t KnightTour::enumerateTours(const int& start, const bool& closed, const int& threads, const TourVisitor& visit) const {
+    return search(start, closed, threads, &visit);
+}
+
+/**
+ * @brief Shared by countTours() and enumerateTours(); visit is null when only counting
+ */
+uint64_t KnightTour::search(const int& start, const bool& closed, const int& threads, const TourVisitor* visit) const {
+    if (squares() > MAX_ENUMERATION_SQUARES || start < 0 || start >= squares()) { return 0; }
+    int workers = threads < 1 ? 1 : threads;
+
+    // Expand the first jumps into the work queue, one ply at a time, until there is enough to share out
+    std::vector<std::vector<uint8_t>> prefixes(1, std::vector<uint8_t>(1, uint8_t(start)));
+    for (int length = 1; length < MAX_PREFIX_LENGTH && length < squares() && prefixes.size() < PREFIXES_PER_THREAD * workers; length++) {
+        std::vector<std::vector<uint8_t>> longer;
+        for (const std::vector<uint8_t>& prefix : prefixes) {
+            uint64_t visited = 0;
+            for (const uint8_t& sq : prefix) { visited |= uint64_t(1) << sq; }
+            for (uint64_t open = neighborMasks_[prefix.back()] & ~visited; open; open &= open - 1) {
+                longer.push_back(prefix);
+                longer.back().push_back(uint8_t(__builtin_ctzll(open)));
+            }
+        }
+        prefixes.swap(longer);
+    }
+
+    if (visit) { return runWorkers<true>(prefixes, neighborMasks_.data(), squares(), start, closed, workers, visit); }
+    return runWorkers<false>(prefixes, neighborMasks_.data(), squares(), start, closed, workers, nullptr);
+}
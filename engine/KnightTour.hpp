@@ -0,0 +1,111 @@
+/**
+ * @class KnightTour
+ * @brief Knight's tours on a rows x columns board: finds one tour on boards of any size, or counts and enumerates
+ *        every tour on boards of up to 64 squares
+ *
+ * The knight move graph is built once per board from the Knight's movement rule (one square along one axis and two
+ * along the other, as in PieceRules::knight()); on 8x8 it matches Attacks::knight(). Squares are numbered
+ * row * columns + column.
+ *
+ * findTour() walks by Warnsdorff's rule: always jump to the unvisited square with the fewest unvisited neighbors,
+ * breaking ties by the fewest unvisited squares two jumps on, then by the greatest distance from the centre. When the
+ * walk gets stuck, the path is rotated (its tail reversed) to give it a new end, and failed walks are retried with
+ * random tie-breaking. countTours() and enumerateTours() run an exhaustive backtracking search with the visited
+ * squares and each square's neighbors held in 64-bit masks. As in ParallelPerft, the first jumps are expanded up front
+ * into a queue of path prefixes that the worker threads share.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class KnightTour {
+    public:
+        // Boards with more squares than this cannot be counted or enumerated (their visited squares don't fit a mask)
+        static constexpr int MAX_ENUMERATION_SQUARES = 64;
+
+        // Called with each tour found by enumerateTours(): the squares in the order the knight visits them
+        typedef std::function<void(const std::vector<uint8_t>&)> TourVisitor;
+
+    private:
+        int rows_;
+        int columns_;
+        std::vector<uint32_t> firstNeighbor_;   // Square s's neighbors are neighbors_[firstNeighbor_[s] .. firstNeighbor_[s + 1])
+        std::vector<uint32_t> neighbors_;
+        std::vector<uint64_t> neighborMasks_;   // One mask per square, only for boards of up to 64 squares
+
+        /**
+         * @brief Runs one Warnsdorff walk from `start`, rotating the path whenever its end gets stuck
+         * @param seed Seeds the final tie-break and the choice of rotations, or 0 to break remaining ties by distance
+         *        from the centre
+         * @return True if the walk visited every square
+         */
+        bool walk(const int& start, const uint64_t& seed, std::vector<uint32_t>& tour) const;
+
+        /**
+         * @brief Shared by countTours() and enumerateTours(); visit is null when only counting
+         */
+        uint64_t search(const int& start, const bool& closed, const int& threads, const TourVisitor* visit) const;
+
+    public:
+        /**
+         * @brief Builds the knight move graph of a rows x columns board
+         * @param rows The number of rows. Values below 1 are treated as 1.
+         * @param columns The number of columns. Values below 1 are treated as 1.
+         */
+        KnightTour(const int& rows, const int& columns);
+
+        int rows() const { return rows_; }
+        int columns() const { return columns_; }
+        int squares() const { return rows_ * columns_; }
+        int square(const int& row, const int& col) const { return row * columns_ + col; }
+
+        /**
+         * @brief Gets the number of knight moves from a square
+         */
+        int degree(const int& square) const { return int(firstNeighbor_[square + 1] - firstNeighbor_[square]); }
+
+        /**
+         * @brief Gets the squares a knight on `square` can jump to
+         */
+        const uint32_t* neighbors(const int& square) const { return neighbors_.data() + firstNeighbor_[square]; }
+
+        /**
+         * @brief Gets the squares a knight on `square` can jump to as a mask
+         * @note Only for boards of up to MAX_ENUMERATION_SQUARES squares
+         */
+        uint64_t neighborMask(const int& square) const { return neighborMasks_[square]; }
+
+        /**
+         * @brief Checks that `tour` visits every square exactly once, one knight move at a time
+         * @param closed Also require a knight move from the last square back to the first
+         */
+        bool isTour(const std::vector<uint32_t>& tour, const bool& closed) const;
+
+        /**
+         * @brief Finds one open tour starting on `start` by Warnsdorff's rule
+         * @note Boards of up to MAX_ENUMERATION_SQUARES squares fall back to a bounded exhaustive search, which finds
+         *       the tours the walks miss
+         * @param tour Receives the squares in visiting order, or is left empty if no tour was found
+         * @return True if a tour was found
+         */
+        bool findTour(const int& start, std::vector<uint32_t>& tour) const;
+
+        /**
+         * @brief Counts the tours starting on `start`
+         * @param closed Count only closed tours (whose last square is a knight move from the first). Each closed tour
+         *        is counted once per direction.
+         * @param threads The number of worker threads. Values below 1 are treated as 1.
+         * @return The number of tours, or 0 if the board has more than MAX_ENUMERATION_SQUARES squares
+         */
+        uint64_t countTours(const int& start, const bool& closed, const int& threads) const;
+
+        /**
+         * @brief Counts the tours starting on `start` and passes each one to `visit`
+         * @param visit Called once per tour, from the worker threads, but never from two at a time
+         * @return The number of tours, or 0 if the board has more than MAX_ENUMERATION_SQUARES squares
+         */
+        uint64_t enumerateTours(const int& start, const bool& closed, const int& threads, const TourVisitor& visit) const;
+};
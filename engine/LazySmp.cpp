@@ -0,0 +1,100 @@
+#include "LazySmp.hpp"
+#include <algorithm>
+#include <thread>
+
+/**
+ * @brief Parameterized constructor.
+ * @param table The table shared by all threads
+ * @param threads The number of search threads, including the main one. Clamped to [1, MAX_THREADS].
+ */
+LazySmp::LazySmp(TranspositionTable& table, const int& threads) : table_{table}, stop_{false}, running_{false} {
+    setThreads(threads);
+}
+
+/**
+ * @brief Changes the number of search threads. Must not be called while a search is running.
+ */
+void LazySmp::setThreads(const int& threads) {
+    int count = std::max(1, std::min(threads, MAX_THREADS));
+    searches_.resize(count);
+    for (int i = 0; i < count; i++) {
+        if (searches_[i]) { continue; }
+        searches_[i].reset(new Search(table_));
+        searches_[i]->shareStopSignal(stop_);
+        searches_[i]->setHelperIndex(i);
+        searches_[i]->shareTableGeneration();
+    }
+    searches_[0]->onIteration(onIteration_);
+}
+
+/**
+ * @brief Sets a function to call after each of the main thread's completed iterations
+ */
+void LazySmp::onIteration(const std::function<void(const SearchResult&)>& callback) {
+    onIteration_ = callback;
+    searches_[0]->onIteration(onIteration_);
+}
+
+/**
+ * @brief Searches the position on all threads until the main thread hits one of the limits (or stop())
+ * @param board The position. It is not modified.
+ * @param limits Depth, node and time limits, all applied to the main thread
+ * @return The main thread's deepest completed iteration; its node count is the total over all threads
+ */
+SearchResult LazySmp::run(const ChessBoard& board, const SearchLimits& limits) {
+    stop_.store(false);
+    running_.store(true);
+
+    // Every thread stamps its entries with this search's generation, so it starts before any of them does
+    table_.newSearch();
+
+    // Helpers only stop on the shared signal, or when they finish the main thread's maximum depth
+    SearchLimits helperLimits;
+    helperLimits.depth = limits.depth;
+
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < searches_.size(); i++) {
+        Search* search = searches_[i].get();
+        helpers.emplace_back([search, &board, &helperLimits]() {
+            ChessBoard own(board);
+            search->run(own, helperLimits);
+        });
+    }
+
+    ChessBoard own(board);
+    SearchResult result = searches_[0]->run(own, limits);
+
+    stop_.store(true);
+    for (size_t i = 0; i < helpers.size(); i++) { helpers[i].join(); }
+    running_.store(false);
+
+    result.nodes = nodes();
+    return result;
+}
+
+/**
+ * @brief Gets the main thread's best line so far. Safe to call from any thread.
+ */
+SearchResult LazySmp::bestSoFar() const {
+    SearchResult result = searches_[0]->bestSoFar();
+    result.nodes = nodes();
+    return result;
+}
+
+/**
+ * @brief Gets the number of nodes searched by each thread in the current (or last) run; index 0 is the main thread
+ */
+std::vector<uint64_t> LazySmp::threadNodes() const {
+    std::vector<uint64_t> counts;
+    for (size_t i = 0; i < searches_.size(); i++) { counts.push_back(searches_[i]->nodes()); }
+    return counts;
+}
+
+/**
+ * @brief Gets the number of nodes searched by all threads in the current (or last) run
+ */
+uint64_t LazySmp::nodes() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < searches_.size(); i++) { total += searches_[i]->nodes(); }
+    return total;
+}
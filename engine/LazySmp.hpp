@@ -0,0 +1,89 @@
+/**
+ * @class LazySmp
+ * @brief Multithreaded best-move search: one main Search plus helper Searches sharing a TranspositionTable
+ *
+ * Every thread searches the same root position on its own copy of the board. Helpers iterate over staggered depths
+ * (see Search::setHelperIndex()) and communicate with the main thread only through the shared table, where their
+ * results turn into cutoffs and better move ordering for everyone else. The main thread owns the time and node
+ * limits and the final answer: when it finishes, it raises the shared stop signal and all helpers unwind.
+ *
+ * The thread count may be changed between searches. Node counters are kept per thread and may be read while a
+ * search runs, to measure how time-to-depth and nodes per second scale with the thread count.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "../ChessBoard.hpp"
+#include "Search.hpp"
+#include "TranspositionTable.hpp"
+
+class LazySmp {
+    private:
+        TranspositionTable& table_;
+        std::atomic<bool> stop_;
+        std::atomic<bool> running_;
+        std::vector<std::unique_ptr<Search>> searches_;   // searches_[0] is the main thread
+        std::function<void(const SearchResult&)> onIteration_;
+
+    public:
+        static constexpr int MAX_THREADS = 256;
+
+        /**
+         * @brief Parameterized constructor.
+         * @param table The table shared by all threads
+         * @param threads The number of search threads, including the main one. Clamped to [1, MAX_THREADS].
+         */
+        LazySmp(TranspositionTable& table, const int& threads = 1);
+
+        LazySmp(const LazySmp&) = delete;
+        LazySmp& operator=(const LazySmp&) = delete;
+
+        /**
+         * @brief Changes the number of search threads. Must not be called while a search is running.
+         */
+        void setThreads(const int& threads);
+        int threads() const { return int(searches_.size()); }
+
+        /**
+         * @brief Searches the position on all threads until the main thread hits one of the limits (or stop())
+         * @param board The position. It is not modified.
+         * @param limits Depth, node and time limits, all applied to the main thread
+         * @return The main thread's deepest completed iteration; its node count is the total over all threads
+         */
+        SearchResult run(const ChessBoard& board, const SearchLimits& limits);
+
+        /**
+         * @brief Asks all threads to stop as soon as possible. Safe to call from any thread.
+         */
+        void stop() { stop_.store(true); }
+
+        /**
+         * @brief Checks whether run() is in progress. Safe to call from any thread.
+         */
+        bool isRunning() const { return running_.load(); }
+
+        /**
+         * @brief Gets the main thread's best line so far. Safe to call from any thread.
+         */
+        SearchResult bestSoFar() const;
+
+        /**
+         * @brief Gets the number of nodes searched by each thread in the current (or last) run; index 0 is the main thread
+         */
+        std::vector<uint64_t> threadNodes() const;
+
+        /**
+         * @brief Gets the number of nodes searched by all threads in the current (or last) run
+         */
+        uint64_t nodes() const;
+
+        /**
+         * @brief Sets a function to call after each of the main thread's completed iterations
+         */
+        void onIteration(const std::function<void(const SearchResult&)>& callback);
+};
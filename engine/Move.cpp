@@ -0,0 +1,26 @@
+#include "Move.hpp"
+#include "Bitboard.hpp"
+
+/**
+ * @brief Gets the name of a square in algebraic notation (eg. "e2")
+ * @note Column 0 is the h-file and row 0 is the 8th rank, so the default ChessBoard reads like a standard board
+ */
+std::string Move::squareName(const int& sq) {
+    std::string name(2, ' ');
+    name[0] = char('a' + (7 - Bitboards::colOf(sq)));
+    name[1] = char('1' + (7 - Bitboards::rowOf(sq)));
+    return name;
+}
+
+/**
+ * @brief Converts the move to long algebraic (UCI) notation, eg. "e2e4" or "e7e8q"
+ */
+std::string Move::toString() const {
+    static const char PROMOTION_LETTERS[PIECE_KIND_COUNT] = { 'p', 'n', 'b', 'r', 'q', 'k' };
+
+    if (isNull()) { return "0000"; }
+
+    std::string text = squareName(from()) + squareName(to());
+    if (isPromotion()) { text += PROMOTION_LETTERS[promotionKind()]; }
+    return text;
+}
@@ -0,0 +1,123 @@
+/**
+ * @class Move
+ * @brief A chess move packed into 16 bits: origin square, target square and a 4-bit flag
+ *
+ *     bits  0-5  : origin square (see Bitboard.hpp for the square layout)
+ *     bits  6-11 : target square
+ *     bits 12-15 : flag (QUIET, DOUBLE_PUSH, SHORT_CASTLE, LONG_CASTLE, CAPTURE, EN_PASSANT, promotions)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "Types.hpp"
+
+class Move {
+    private:
+        uint16_t data_;
+
+    public:
+        // Flags. Bit 2 marks a capture, bit 3 marks a promotion and the low two bits pick the promoted kind.
+        static constexpr int QUIET = 0;
+        static constexpr int DOUBLE_PUSH = 1;
+        static constexpr int SHORT_CASTLE = 2;    // King moves two columns towards column 0
+        static constexpr int LONG_CASTLE = 3;     // King moves two columns towards column 7
+        static constexpr int CAPTURE = 4;
+        static constexpr int EN_PASSANT = 5;
+        static constexpr int PROMOTION = 8;       // + (kind - KNIGHT_KIND), optionally + CAPTURE
+
+        /**
+         * @brief Default constructor. Creates the null move (origin == target == 0)
+         */
+        Move() : data_{0} {}
+
+        /**
+         * @brief Parameterized constructor.
+         * @param from The origin square
+         * @param to The target square
+         * @param flag One of the flags above. Default value QUIET if not provided.
+         */
+        Move(const int& from, const int& to, const int& flag = QUIET) : data_{uint16_t(from | (to << 6) | (flag << 12))} {}
+
+        /**
+         * @brief Rebuilds a move from the 16 bits returned by raw()
+         */
+        static Move fromRaw(const uint16_t& raw) { return Move(raw & 0x3F, (raw >> 6) & 0x3F, raw >> 12); }
+
+        /**
+         * @brief Builds the flag for a promotion to the given kind
+         */
+        static int promotionFlag(const int& kind, const bool& capture) {
+            return PROMOTION | (kind - KNIGHT_KIND) | (capture ? CAPTURE : 0);
+        }
+
+        int from() const { return data_ & 0x3F; }
+        int to() const { return (data_ >> 6) & 0x3F; }
+        int flag() const { return data_ >> 12; }
+        uint16_t raw() const { return data_; }
+
+        bool isNull() const { return data_ == 0; }
+        bool isCapture() const { return (flag() & CAPTURE) != 0; }
+        bool isPromotion() const { return (flag() & PROMOTION) != 0; }
+        bool isCastle() const { return flag() == SHORT_CASTLE || flag() == LONG_CASTLE; }
+
+        /**
+         * @brief Gets the kind a pawn is promoted to
+         * @pre isPromotion() is true
+         */
+        int promotionKind() const { return KNIGHT_KIND + (flag() & 3); }
+
+        bool operator==(const Move& other) const { return data_ == other.data_; }
+        bool operator!=(const Move& other) const { return data_ != other.data_; }
+
+        /**
+         * @brief Gets the name of a square in algebraic notation (eg. "e2")
+         * @note Column 0 is the h-file and row 0 is the 8th rank, so the default ChessBoard reads like a standard board
+         */
+        static std::string squareName(const int& sq);
+
+        /**
+         * @brief Converts the move to long algebraic (UCI) notation, eg. "e2e4" or "e7e8q"
+         */
+        std::string toString() const;
+};
+
+/**
+ * @class MoveList
+ * @brief A fixed-capacity list of moves that lives on the stack
+ */
+class MoveList {
+    public:
+        static constexpr int CAPACITY = 256; // Comfortably above the largest known number of legal moves (218)
+
+    private:
+        Move moves_[CAPACITY];
+        int size_;
+
+    public:
+        MoveList() : size_{0} {}
+
+        void push_back(const Move& move) { moves_[size_++] = move; }
+        void clear() { size_ = 0; }
+        int size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        Move& operator[](const int& i) { return moves_[i]; }
+        const Move& operator[](const int& i) const { return moves_[i]; }
+
+        Move* begin() { return moves_; }
+        Move* end() { return moves_ + size_; }
+        const Move* begin() const { return moves_; }
+        const Move* end() const { return moves_ + size_; }
+
+        /**
+         * @brief Determines whether the list contains the given move
+         */
+        bool contains(const Move& move) const {
+            for (int i = 0; i < size_; i++) {
+                if (moves_[i] == move) { return true; }
+            }
+            return false;
+        }
+};
@@ -0,0 +1,197 @@
+#include "MoveOrdering.hpp"
+#include <algorithm>
+#include <cstring>
+#include "Search.hpp"
+
+namespace {
+    // Ordering bands; see the class description
+    const int TABLE_MOVE_SCORE = 1 << 30;
+    const int GOOD_CAPTURE_SCORE = 1 << 28;
+    const int KILLER_SCORE = 1 << 27;
+    const int BAD_CAPTURE_SCORE = -(1 << 28);
+
+    // Piece kinds from the least to the most valuable aggressor; the King always recaptures last
+    const int AGGRESSOR_ORDER[PIECE_KIND_COUNT] = { PAWN_KIND, KNIGHT_KIND, BISHOP_KIND, ROOK_KIND, QUEEN_KIND, KING_KIND };
+
+    // Longest possible exchange on one square, plus the initial capture
+    const int MAX_EXCHANGE = 34;
+
+    /**
+     * @brief Gets the kind of piece a move takes off the board, or NO_PIECE_KIND
+     */
+    int victimKind(const ChessBoard& board, const Move& move) {
+        if (move.flag() == Move::EN_PASSANT) { return PAWN_KIND; }
+        uint8_t code = board.pieceCodeAt(move.to());
+        return (code == PieceCodes::NO_PIECE) ? int(NO_PIECE_KIND) : PieceCodes::kindOf(code);
+    }
+}
+
+/**
+ * @brief Default constructor. Starts with empty killer and history tables.
+ */
+MoveOrdering::MoveOrdering() {
+    clear();
+}
+
+/**
+ * @brief Empties the killer and history tables
+ */
+void MoveOrdering::clear() {
+    for (int ply = 0; ply < MAX_PLY; ply++) { killers_[ply][0] = killers_[ply][1] = Move(); }
+    std::memset(history_, 0, sizeof(history_));
+}
+
+/**
+ * @brief Halves every history score and forgets the killers, so a new search keeps a fading memory of the last
+ */
+void MoveOrdering::age() {
+    for (int ply = 0; ply < MAX_PLY; ply++) { killers_[ply][0] = killers_[ply][1] = Move(); }
+    int* entry = &history_[0][0][0];
+    for (size_t i = 0; i < sizeof(history_) / sizeof(int); i++) { entry[i] /= 2; }
+}
+
+/**
+ * @brief Moves a history score towards +/- HISTORY_MAX by `bonus`, slowing down as it gets closer
+ */
+void MoveOrdering::applyBonus(int& entry, const int& bonus) {
+    int clamped = std::max(-HISTORY_MAX, std::min(bonus, HISTORY_MAX));
+    entry += clamped - entry * std::abs(clamped) / HISTORY_MAX;
+}
+
+/**
+ * @brief Scores every move of the list for the given node (higher is tried earlier)
+ * @param scores Receives one score per move, in list order
+ */
+void MoveOrdering::score(const ChessBoard& board, const MoveList& moves, const Move& tableMove, const int& ply, int* scores) const {
+    int side = board.sideToMove();
+    for (int i = 0; i < moves.size(); i++) {
+        const Move& move = moves[i];
+        if (move == tableMove) {
+            scores[i] = TABLE_MOVE_SCORE;
+        } else if (move.isCapture() || move.isPromotion()) {
+            int band = (staticExchange(board, move) >= 0) ? GOOD_CAPTURE_SCORE : BAD_CAPTURE_SCORE;
+            scores[i] = band + mvvLva(board, move);
+        } else if (killers_[ply][0] == move) {
+            scores[i] = KILLER_SCORE + 1;
+        } else if (killers_[ply][1] == move) {
+            scores[i] = KILLER_SCORE;
+        } else {
+            scores[i] = history_[side][move.from()][move.to()];
+        }
+    }
+}
+
+/**
+ * @brief Selection step: swaps the best scored move among [index, size) into `index` and returns it
+ */
+Move MoveOrdering::pickNext(MoveList& moves, int* scores, const int& index) {
+    int best = index;
+    for (int i = index + 1; i < moves.size(); i++) {
+        if (scores[i] > scores[best]) { best = i; }
+    }
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+    return moves[index];
+}
+
+/**
+ * @brief Checks whether score() put a move in the band of captures that lose material by static exchange
+ * @note Only that band lies below the history scores of quiet moves
+ */
+bool MoveOrdering::losesExchange(const int& score) {
+    return score < -HISTORY_MAX;
+}
+
+/**
+ * @brief Records a quiet move that caused a beta cutoff, and penalizes the quiet moves tried before it
+ * @param tried The quiet moves searched at this node before `move`
+ * @param triedCount The number of entries in `tried`
+ */
+void MoveOrdering::updateQuiet(const ChessBoard& board, const Move& move, const int& depth, const int& ply,
+                               const Move* tried, const int& triedCount) {
+    if (killers_[ply][0] != move) {
+        killers_[ply][1] = killers_[ply][0];
+        killers_[ply][0] = move;
+    }
+
+    int side = board.sideToMove();
+    int bonus = depth * depth;
+    applyBonus(history_[side][move.from()][move.to()], bonus);
+    for (int i = 0; i < triedCount; i++) {
+        applyBonus(history_[side][tried[i].from()][tried[i].to()], -bonus);
+    }
+}
+
+/**
+ * @brief Most Valuable Victim - Least Valuable Aggressor score of a capture (or promotion)
+ */
+int MoveOrdering::mvvLva(const ChessBoard& board, const Move& move) {
+    int victim = victimKind(board, move);
+    int gain = (victim == NO_PIECE_KIND) ? 0 : Search::pieceValue(victim);
+    if (move.isPromotion()) { gain += Search::pieceValue(move.promotionKind()) - Search::pieceValue(PAWN_KIND); }
+
+    // Victim values are at least a pawn apart, so the victim always dominates the aggressor
+    int aggressor = PieceCodes::kindOf(board.pieceCodeAt(move.from()));
+    return gain * 10 - Search::pieceValue(aggressor);
+}
+
+/**
+ * @brief Static exchange evaluation: the material the mover wins (or loses, if negative) on the target square
+ *        when both sides keep recapturing there with their least valuable piece, each free to stop when
+ *        recapturing no longer pays. X-ray attackers behind the capturing pieces join in; pins are ignored.
+ * @return The material balance in centipawns. 0 for castling and quiet moves to unattacked squares.
+ */
+int MoveOrdering::staticExchange(const ChessBoard& board, const Move& move) {
+    if (move.isCastle()) { return 0; }
+
+    int from = move.from();
+    int to = move.to();
+    int victim = victimKind(board, move);
+
+    // gain[d]: the material balance for the side making the d-th capture, if the exchange stopped right after it
+    int gain[MAX_EXCHANGE];
+    int depth = 0;
+    gain[0] = (victim == NO_PIECE_KIND) ? 0 : Search::pieceValue(victim);
+
+    int standing = PieceCodes::kindOf(board.pieceCodeAt(from));    // The piece now on the target square
+    if (move.isPromotion()) {
+        gain[0] += Search::pieceValue(move.promotionKind()) - Search::pieceValue(PAWN_KIND);
+        standing = move.promotionKind();
+    }
+
+    Bitboard occupied = board.occupied() ^ Bitboards::squareBit(from);
+    if (move.flag() == Move::EN_PASSANT) {
+        // The captured pawn sits beside the target square, on the mover's row
+        occupied ^= Bitboards::squareBit(Bitboards::square(Bitboards::rowOf(from), Bitboards::colOf(to)));
+    }
+
+    int side = board.sideToMove() ^ 1;
+    while (depth + 1 < MAX_EXCHANGE) {
+        Bitboard attackers = board.attackersOf(to, occupied);
+        Bitboard ours = attackers & board.sidePieces(side);
+        if (!ours) { break; }
+
+        int kind = NO_PIECE_KIND;
+        Bitboard candidates = 0;
+        for (int i = 0; i < PIECE_KIND_COUNT && !candidates; i++) {
+            kind = AGGRESSOR_ORDER[i];
+            candidates = ours & board.pieces(side, kind);
+        }
+
+        // The King may only recapture onto a square the other side no longer attacks
+        if (kind == KING_KIND && (attackers & board.sidePieces(side ^ 1))) { break; }
+
+        depth++;
+        gain[depth] = Search::pieceValue(standing) - gain[depth - 1];
+        standing = kind;
+        occupied ^= Bitboards::squareBit(Bitboards::lowestSquare(candidates));
+        side ^= 1;
+    }
+
+    // Unwind: each side only makes its capture if it does better than stopping before it
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0];
+}
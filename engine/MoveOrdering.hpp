@@ -0,0 +1,91 @@
+/**
+ * @class MoveOrdering
+ * @brief Orders moves for the alpha-beta search so that the move most likely to cause a cutoff is tried first
+ *
+ * Moves are scored in bands, best first:
+ *     1. the transposition table move
+ *     2. captures (and promotions) that do not lose material by static exchange, by MVV-LVA
+ *     3. the two killer moves of the ply: quiet moves that recently caused a cutoff at the same depth
+ *     4. other quiet moves, by their history score
+ *     5. captures that lose material by static exchange, by MVV-LVA
+ *
+ * Piece values are 100 x ChessPiece::size(), as in Search::pieceValue(). Killer and history tables belong to one
+ * search thread and are meant to be cleared (or aged) between searches.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "../ChessBoard.hpp"
+
+class MoveOrdering {
+    public:
+        static constexpr int MAX_PLY = 128;             // Matches Search::MAX_PLY
+        static constexpr int HISTORY_MAX = 16384;       // History scores stay within [-HISTORY_MAX, HISTORY_MAX]
+
+    private:
+        Move killers_[MAX_PLY][2];
+        int history_[SIDE_COUNT][Bitboards::SQUARE_COUNT][Bitboards::SQUARE_COUNT];
+
+        /**
+         * @brief Moves a history score towards +/- HISTORY_MAX by `bonus`, slowing down as it gets closer
+         */
+        static void applyBonus(int& entry, const int& bonus);
+
+    public:
+        /**
+         * @brief Default constructor. Starts with empty killer and history tables.
+         */
+        MoveOrdering();
+
+        /**
+         * @brief Empties the killer and history tables
+         */
+        void clear();
+
+        /**
+         * @brief Halves every history score and forgets the killers, so a new search keeps a fading memory of the last
+         */
+        void age();
+
+        /**
+         * @brief Scores every move of the list for the given node (higher is tried earlier)
+         * @param scores Receives one score per move, in list order
+         */
+        void score(const ChessBoard& board, const MoveList& moves, const Move& tableMove, const int& ply, int* scores) const;
+
+        /**
+         * @brief Selection step: swaps the best scored move among [index, size) into `index` and returns it
+         */
+        static Move pickNext(MoveList& moves, int* scores, const int& index);
+
+        /**
+         * @brief Checks whether score() put a move in the band of captures that lose material by static exchange
+         * @note Lets quiescence skip losing captures without running the exchange a second time
+         */
+        static bool losesExchange(const int& score);
+
+        /**
+         * @brief Records a quiet move that caused a beta cutoff, and penalizes the quiet moves tried before it
+         * @param tried The quiet moves searched at this node before `move`
+         * @param triedCount The number of entries in `tried`
+         */
+        void updateQuiet(const ChessBoard& board, const Move& move, const int& depth, const int& ply,
+                         const Move* tried, const int& triedCount);
+
+        bool isKiller(const Move& move, const int& ply) const { return killers_[ply][0] == move || killers_[ply][1] == move; }
+        int historyScore(const int& side, const Move& move) const { return history_[side][move.from()][move.to()]; }
+
+        /**
+         * @brief Most Valuable Victim - Least Valuable Aggressor score of a capture (or promotion)
+         */
+        static int mvvLva(const ChessBoard& board, const Move& move);
+
+        /**
+         * @brief Static exchange evaluation: the material the mover wins (or loses, if negative) on the target square
+         *        when both sides keep recapturing there with their least valuable piece, each free to stop when
+         *        recapturing no longer pays. X-ray attackers behind the capturing pieces join in; pins are ignored.
+         * @return The material balance in centipawns. 0 for castling and quiet moves to unattacked squares.
+         */
+        static int staticExchange(const ChessBoard& board, const Move& move);
+};
@@ -0,0 +1,65 @@
+#include "PackedPosition.hpp"
+#include <cstring>
+
+/**
+ * @brief Encodes a board's position (pieces, side to move, castling rights, en passant square and counters)
+ * @param packed Receives the encoding
+ * @return False if the board holds more than MAX_PIECES pieces (which no legal game reaches)
+ * @note The move history is not part of the encoding.
+ */
+bool PackedPosition::pack(const ChessBoard& board, PackedPosition& packed) {
+    Bitboard occupied = board.occupied();
+    if (Bitboards::popCount(occupied) > MAX_PIECES) { return false; }
+
+    packed.occupancy = occupied;
+    std::memset(packed.pieces, 0, sizeof(packed.pieces));
+    int index = 0;
+    for (Bitboard remaining = occupied; remaining; index++) {
+        int sq = Bitboards::popLowest(remaining);
+        packed.pieces[index >> 1] |= uint8_t(board.pieceCodeAt(sq) << ((index & 1) * 4));
+    }
+
+    packed.flags = uint8_t(board.getCastlingRights() & CASTLING_MASK);
+    if (board.sideToMove() == PLAYER_ONE) { packed.flags |= PLAYER_ONE_TURN; }
+    int passed = board.getEnPassantSquare();
+    packed.enPassant = (passed == Bitboards::NO_SQUARE) ? NO_EN_PASSANT : uint8_t(passed);
+    int halfmoves = board.getHalfmoveClock();
+    packed.halfmoveClock = uint16_t(halfmoves > 0xFFFF ? 0xFFFF : halfmoves);
+    packed.fullmoveNumber = uint32_t(board.getFullmoveNumber());
+    return true;
+}
+
+/**
+ * @brief Sets up `board` with the encoded position, validating it like ChessBoard::setPosition()
+ * @param error If not null, receives a description of the problem when the record is rejected
+ * @return True if the position was loaded. On false the board is left unchanged.
+ */
+bool PackedPosition::unpack(ChessBoard& board, std::string* error) const {
+    if (Bitboards::popCount(occupancy) > MAX_PIECES) {
+        if (error) { *error = "packed position: more than 32 occupied squares"; }
+        return false;
+    }
+
+    uint8_t codes[Bitboards::SQUARE_COUNT];
+    std::memset(codes, PieceCodes::NO_PIECE, sizeof(codes));
+    int index = 0;
+    for (Bitboard remaining = occupancy; remaining; index++) {
+        int sq = Bitboards::popLowest(remaining);
+        codes[sq] = (pieces[index >> 1] >> ((index & 1) * 4)) & 0x0F;
+        if (codes[sq] >= PieceCodes::NO_PIECE) {
+            if (error) { *error = "packed position: invalid piece code on an occupied square"; }
+            return false;
+        }
+    }
+
+    if (!board.setPosition(codes, (flags & PLAYER_ONE_TURN) != 0, castlingRights(), enPassantSquare(),
+                           halfmoveClock, int(fullmoveNumber), error)) {
+        if (error) { error->insert(0, "packed position: "); }
+        return false;
+    }
+    return true;
+}
+
+bool PackedPosition::operator==(const PackedPosition& other) const {
+    return std::memcmp(this, &other, sizeof(PackedPosition)) == 0;
+}
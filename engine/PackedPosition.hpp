@@ -0,0 +1,69 @@
+/**
+ * @class PackedPosition
+ * @brief A fixed-size, 32-byte binary encoding of a ChessBoard position, for storing positions by the million
+ *
+ * Layout (native byte order, no padding):
+ *     occupancy       8 bytes   Bitboard of occupied squares
+ *     pieces         16 bytes   A 4-bit piece code per occupied square, in ascending square order, low nibble first
+ *     flags           1 byte    Castling rights in bits 0-3 (ChessBoard's *_CASTLE bits), player one's turn in bit 4
+ *     enPassant       1 byte    ChessBoard::getEnPassantSquare(), or NO_EN_PASSANT
+ *     halfmoveClock   2 bytes   Saturates at 65535
+ *     fullmoveNumber  4 bytes
+ *
+ * A legal position holds at most 32 pieces, so 16 bytes of nibbles always suffice. Records are plain data: they can
+ * be read straight out of a file or a memory map, and single squares can be queried without decoding the record.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "../ChessBoard.hpp"
+
+struct PackedPosition {
+    static constexpr int MAX_PIECES = 32;
+    static constexpr uint8_t CASTLING_MASK = 0x0F;
+    static constexpr uint8_t PLAYER_ONE_TURN = 0x10;
+    static constexpr uint8_t NO_EN_PASSANT = 0xFF;
+
+    uint64_t occupancy;
+    uint8_t pieces[MAX_PIECES / 2];
+    uint8_t flags;
+    uint8_t enPassant;
+    uint16_t halfmoveClock;
+    uint32_t fullmoveNumber;
+
+    /**
+     * @brief Encodes a board's position (pieces, side to move, castling rights, en passant square and counters)
+     * @param packed Receives the encoding
+     * @return False if the board holds more than MAX_PIECES pieces (which no legal game reaches)
+     * @note The move history is not part of the encoding.
+     */
+    static bool pack(const ChessBoard& board, PackedPosition& packed);
+
+    /**
+     * @brief Sets up `board` with the encoded position, validating it like ChessBoard::setPosition()
+     * @param error If not null, receives a description of the problem when the record is rejected
+     * @return True if the position was loaded. On false the board is left unchanged.
+     */
+    bool unpack(ChessBoard& board, std::string* error = nullptr) const;
+
+    /**
+     * @brief Gets the piece code on a square straight from the record, or PieceCodes::NO_PIECE if it is empty
+     */
+    uint8_t pieceCodeAt(const int& sq) const {
+        Bitboard bit = Bitboards::squareBit(sq);
+        if (!(occupancy & bit)) { return PieceCodes::NO_PIECE; }
+        int index = Bitboards::popCount(occupancy & (bit - 1));
+        return (pieces[index >> 1] >> ((index & 1) * 4)) & 0x0F;
+    }
+
+    int sideToMove() const { return (flags & PLAYER_ONE_TURN) ? PLAYER_ONE : PLAYER_TWO; }
+    int castlingRights() const { return flags & CASTLING_MASK; }
+    int enPassantSquare() const { return enPassant == NO_EN_PASSANT ? Bitboards::NO_SQUARE : int(enPassant); }
+
+    bool operator==(const PackedPosition& other) const;
+    bool operator!=(const PackedPosition& other) const { return !(*this == other); }
+};
+
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition must stay 32 bytes: it is the on-disk record format");
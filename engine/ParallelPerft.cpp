@@ -0,0 +1,118 @@
+#include "ParallelPerft.hpp"
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    const size_t BYTES_PER_MEGABYTE = size_t(1) << 20;
+    const std::memory_order RELAXED = std::memory_order_relaxed;
+}
+
+/**
+ * @brief Constructs a table of (at most) the given size. 0 MiB disables caching.
+ */
+ParallelPerft::CountTable::CountTable(const size_t& megabytes) : slotCount_{0} {
+    size_t requested = (megabytes * BYTES_PER_MEGABYTE) / sizeof(Slot);
+    if (requested == 0) { return; }
+
+    slotCount_ = 1;
+    while (slotCount_ <= requested / 2) { slotCount_ *= 2; }
+    slots_.reset(new Slot[slotCount_]);
+    for (size_t i = 0; i < slotCount_; i++) {
+        slots_[i].check.store(0, RELAXED);
+        slots_[i].data.store(0, RELAXED);
+    }
+}
+
+bool ParallelPerft::CountTable::probe(const uint64_t& hash, const int& depth, uint64_t& count) const {
+    uint64_t key = keyFor(hash, depth);
+    const Slot& slot = slots_[key & (slotCount_ - 1)];
+    uint64_t data = slot.data.load(RELAXED);
+    if ((slot.check.load(RELAXED) ^ data) != key || int(data & 0xFF) != depth) { return false; }
+
+    count = data >> 8;
+    return true;
+}
+
+void ParallelPerft::CountTable::store(const uint64_t& hash, const int& depth, const uint64_t& count) {
+    uint64_t key = keyFor(hash, depth);
+    uint64_t data = (count << 8) | uint64_t(depth);
+    Slot& slot = slots_[key & (slotCount_ - 1)];
+    slot.check.store(key ^ data, RELAXED);
+    slot.data.store(data, RELAXED);
+}
+
+/**
+ * @brief Parameterized constructor.
+ * @param threads The number of worker threads. Values below 1 are treated as 1.
+ * @param hashMegabytes The size of the subtree count cache in MiB. 0 disables it.
+ */
+ParallelPerft::ParallelPerft(const int& threads, const size_t& hashMegabytes)
+    : threads_{threads < 1 ? 1 : threads}, hashMegabytes_{hashMegabytes} {}
+
+/**
+ * @brief Counts the leaves below `board`, using and filling the cache
+ */
+uint64_t ParallelPerft::countNodes(ChessBoard& board, const int& depth, CountTable& table) {
+    // Shallow subtrees are cheaper to bulk count than to look up
+    if (depth <= 2 || !table.enabled()) { return board.perft(depth); }
+
+    uint64_t nodes = 0;
+    if (table.probe(board.hash(), depth, nodes)) { return nodes; }
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    for (const Move& move : moves) {
+        board.makeMove(move);
+        nodes += countNodes(board, depth - 1, table);
+        board.unmakeMove();
+    }
+
+    table.store(board.hash(), depth, nodes);
+    return nodes;
+}
+
+/**
+ * @brief Counts the leaf nodes of the legal move tree below `root` to the given depth
+ * @note The root board is not modified; every worker plays on its own copy.
+ */
+uint64_t ParallelPerft::run(const ChessBoard& root, const int& depth) const {
+    ChessBoard scratch(root);
+    if (depth <= 2) { return scratch.perft(depth); }
+
+    // Expand the first two plies into the work queue
+    std::vector<std::pair<Move, Move>> work;
+    MoveList first;
+    scratch.generateLegalMoves(first);
+    for (const Move& move : first) {
+        scratch.makeMove(move);
+        MoveList replies;
+        scratch.generateLegalMoves(replies);
+        for (const Move& reply : replies) { work.push_back(std::make_pair(move, reply)); }
+        scratch.unmakeMove();
+    }
+
+    CountTable table(hashMegabytes_);
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> total{0};
+
+    auto worker = [&]() {
+        ChessBoard board(root);
+        uint64_t nodes = 0;
+        for (size_t i = next.fetch_add(1); i < work.size(); i = next.fetch_add(1)) {
+            board.makeMove(work[i].first);
+            board.makeMove(work[i].second);
+            nodes += countNodes(board, depth - 2, table);
+            board.unmakeMove();
+            board.unmakeMove();
+        }
+        total.fetch_add(nodes);
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads_; i++) { pool.emplace_back(worker); }
+    worker();  // The calling thread works too
+    for (size_t i = 0; i < pool.size(); i++) { pool[i].join(); }
+
+    return total.load();
+}
@@ -0,0 +1,71 @@
+/**
+ * @class ParallelPerft
+ * @brief Perft split across a pool of worker threads, with optional memoization of subtree counts
+ *
+ * The first two plies are expanded up front into a queue of (move, reply) pairs. Each worker owns a copy of the
+ * root board and pulls pairs off the queue until it is empty, so long and short subtrees balance out across threads.
+ * Below the split, subtree counts can be cached in a shared lock-free table keyed by position hash and depth;
+ * transpositions then cost one probe instead of a full re-count. Node counts are identical to ChessBoard::perft().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "../ChessBoard.hpp"
+
+class ParallelPerft {
+    private:
+        /**
+         * @brief A lock-free (position, depth) -> node count cache, verified with the same XOR trick as the TranspositionTable
+         */
+        class CountTable {
+            private:
+                struct Slot {
+                    std::atomic<uint64_t> check;   // key ^ data
+                    std::atomic<uint64_t> data;    // count << 8 | depth
+                };
+
+                std::unique_ptr<Slot[]> slots_;
+                size_t slotCount_;                 // A power of two, or 0 when the table is disabled
+
+                /**
+                 * @brief Spreads the depth into the key, so one position at different depths uses different slots
+                 */
+                static uint64_t keyFor(const uint64_t& hash, const int& depth) { return hash ^ (uint64_t(depth) * 0x9E3779B97F4A7C15ULL); }
+
+            public:
+                /**
+                 * @brief Constructs a table of (at most) the given size. 0 MiB disables caching.
+                 */
+                explicit CountTable(const size_t& megabytes);
+
+                bool enabled() const { return slotCount_ != 0; }
+                bool probe(const uint64_t& hash, const int& depth, uint64_t& count) const;
+                void store(const uint64_t& hash, const int& depth, const uint64_t& count);
+        };
+
+        int threads_;
+        size_t hashMegabytes_;
+
+        /**
+         * @brief Counts the leaves below `board`, using and filling the cache
+         */
+        static uint64_t countNodes(ChessBoard& board, const int& depth, CountTable& table);
+
+    public:
+        /**
+         * @brief Parameterized constructor.
+         * @param threads The number of worker threads. Values below 1 are treated as 1.
+         * @param hashMegabytes The size of the subtree count cache in MiB. 0 disables it.
+         */
+        ParallelPerft(const int& threads, const size_t& hashMegabytes);
+
+        /**
+         * @brief Counts the leaf nodes of the legal move tree below `root` to the given depth
+         * @note The root board is not modified; every worker plays on its own copy.
+         */
+        uint64_t run(const ChessBoard& root, const int& depth) const;
+};
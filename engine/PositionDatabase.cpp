@@ -0,0 +1,194 @@
+#include "PositionDatabase.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // Records claimed at a time by a scanning thread: 128 KiB, large enough to amortize the claim and let the
+    // kernel's readahead work, small enough to balance the threads
+    const size_t SCAN_BLOCK = 4096;
+
+    /**
+     * @brief Fills in a header for `count` records
+     */
+    PositionDatabase::Header makeHeader(const uint64_t& count) {
+        PositionDatabase::Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, PositionDatabase::MAGIC, sizeof(header.magic));
+        header.byteOrderMark = PositionDatabase::BYTE_ORDER_MARK;
+        header.version = PositionDatabase::VERSION;
+        header.recordSize = sizeof(PackedPosition);
+        header.count = count;
+        return header;
+    }
+
+    bool fail(std::string* error, const std::string& message) {
+        if (error) { *error = message; }
+        return false;
+    }
+}
+
+PositionDatabaseWriter::PositionDatabaseWriter() : file_{nullptr}, count_{0} {}
+
+/**
+ * @brief Closes the file (see close())
+ */
+PositionDatabaseWriter::~PositionDatabaseWriter() {
+    close();
+}
+
+/**
+ * @brief Creates (or truncates) a database file and writes a header marked incomplete (see close())
+ * @param error If not null, receives a description of the problem on failure
+ * @return False if the file could not be created
+ */
+bool PositionDatabaseWriter::open(const std::string& path, std::string* error) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) { return fail(error, "cannot create " + path + ": " + std::strerror(errno)); }
+
+    count_ = 0;
+    PositionDatabase::Header header = makeHeader(PositionDatabase::INCOMPLETE);
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return fail(error, "cannot write to " + path);
+    }
+    return true;
+}
+
+/**
+ * @brief Appends one record
+ * @return False if no file is open or the write failed
+ */
+bool PositionDatabaseWriter::append(const PackedPosition& record) {
+    if (!file_ || std::fwrite(&record, sizeof(record), 1, file_) != 1) { return false; }
+    count_++;
+    return true;
+}
+
+/**
+ * @brief Packs a board's position and appends it
+ * @return False if the position cannot be packed (see PackedPosition::pack()) or the write failed
+ */
+bool PositionDatabaseWriter::append(const ChessBoard& board) {
+    PackedPosition record;
+    return PackedPosition::pack(board, record) && append(record);
+}
+
+/**
+ * @brief Writes the final record count into the header and closes the file
+ * @return False if the file could not be completed, or none was open
+ */
+bool PositionDatabaseWriter::close() {
+    if (!file_) { return false; }
+
+    PositionDatabase::Header header = makeHeader(count_);
+    bool ok = std::fseek(file_, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    ok = (std::fclose(file_) == 0) && ok;
+    file_ = nullptr;
+    return ok;
+}
+
+PositionDatabaseReader::PositionDatabaseReader() : mapping_{nullptr}, mappedBytes_{0}, records_{nullptr}, count_{0} {}
+
+/**
+ * @brief Unmaps the file (see close())
+ */
+PositionDatabaseReader::~PositionDatabaseReader() {
+    close();
+}
+
+/**
+ * @brief Maps a database file, checking its header
+ * @param error If not null, receives a description of the problem on failure
+ * @return False if the file cannot be mapped or is not a complete database of this format
+ */
+bool PositionDatabaseReader::open(const std::string& path, std::string* error) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return fail(error, "cannot open " + path + ": " + std::strerror(errno)); }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(PositionDatabase::Header)) {
+        ::close(fd);
+        return fail(error, path + " is too short to be a position database");
+    }
+    size_t bytes = size_t(info.st_size);
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // The mapping keeps the file open
+    if (mapping == MAP_FAILED) { return fail(error, "cannot map " + path + ": " + std::strerror(errno)); }
+
+    const PositionDatabase::Header* header = static_cast<const PositionDatabase::Header*>(mapping);
+    std::string problem;
+    if (std::memcmp(header->magic, PositionDatabase::MAGIC, sizeof(header->magic)) != 0) {
+        problem = " is not a position database";
+    } else if (header->byteOrderMark != PositionDatabase::BYTE_ORDER_MARK) {
+        problem = " was written with the other byte order";
+    } else if (header->version != PositionDatabase::VERSION || header->recordSize != sizeof(PackedPosition)) {
+        problem = " has an unsupported version or record size";
+    } else if (header->count == PositionDatabase::INCOMPLETE) {
+        problem = " was not closed after writing";
+    } else if (header->count > (bytes - sizeof(PositionDatabase::Header)) / sizeof(PackedPosition)) {
+        problem = " is truncated";
+    }
+    if (!problem.empty()) {
+        ::munmap(mapping, bytes);
+        return fail(error, path + problem);
+    }
+
+    mapping_ = mapping;
+    mappedBytes_ = bytes;
+    records_ = reinterpret_cast<const PackedPosition*>(static_cast<const char*>(mapping) + sizeof(PositionDatabase::Header));
+    count_ = size_t(header->count);
+    return true;
+}
+
+/**
+ * @brief Unmaps the file. References to records obtained earlier become invalid.
+ */
+void PositionDatabaseReader::close() {
+    if (mapping_) { ::munmap(mapping_, mappedBytes_); }
+    mapping_ = nullptr;
+    mappedBytes_ = 0;
+    records_ = nullptr;
+    count_ = 0;
+}
+
+/**
+ * @brief Visits every record, splitting the file across worker threads
+ * @param threads The number of threads, including the calling one. Values below 1 are treated as 1.
+ * @param visit Called once per record with the record, its index and the number of the thread that visits it
+ *        (0 .. threads - 1), so callers can keep per-thread state such as a scratch ChessBoard without locking
+ * @note Threads claim blocks of consecutive records in file order, so each one streams through the mapping
+ *       sequentially and fast and slow blocks balance out. The order of the calls is otherwise unspecified.
+ */
+void PositionDatabaseReader::scan(const int& threads,
+                                  const std::function<void(const PackedPosition& record, const size_t& index, const int& thread)>& visit) const {
+    if (count_ == 0) { return; }
+    // The whole file is about to be read once, front to back
+    ::madvise(mapping_, mappedBytes_, MADV_SEQUENTIAL);
+
+    std::atomic<size_t> nextBlock{0};
+    auto work = [this, &nextBlock, &visit](const int& thread) {
+        for (;;) {
+            size_t begin = nextBlock.fetch_add(SCAN_BLOCK, std::memory_order_relaxed);
+            if (begin >= count_) { return; }
+            size_t end = std::min(begin + SCAN_BLOCK, count_);
+            for (size_t i = begin; i < end; i++) { visit(records_[i], i, thread); }
+        }
+    };
+
+    int workers = std::max(1, threads);
+    std::vector<std::thread> helpers;
+    for (int t = 1; t < workers; t++) { helpers.emplace_back(work, t); }
+    work(0);
+    for (std::thread& helper : helpers) { helper.join(); }
+}
@@ -0,0 +1,154 @@
+/**
+ * @file PositionDatabase.hpp
+ * @brief Files of PackedPosition records: a writer that streams them out, and a memory-mapped reader
+ *
+ * A database file is a 32-byte Header followed by `count` PackedPosition records, so record i lives at byte offset
+ * 32 + 32 * i and every record is 32-byte aligned within the file. Files are written in the native byte order; the
+ * header's byte-order mark lets a reader on a machine of the other endianness refuse them.
+ *
+ * The reader maps the file read-only and hands out references into the mapping, so looking a record up copies
+ * nothing, and only the pages actually touched are read from disk.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include "PackedPosition.hpp"
+
+namespace PositionDatabase {
+    /**
+     * @brief The file header
+     */
+    struct Header {
+        char magic[8];               // MAGIC
+        uint32_t byteOrderMark;      // BYTE_ORDER_MARK, as written by the machine that made the file
+        uint32_t version;            // VERSION
+        uint32_t recordSize;         // sizeof(PackedPosition)
+        uint32_t reserved;
+        uint64_t count;              // Number of records after the header, or INCOMPLETE while the file is being written
+    };
+
+    static_assert(sizeof(Header) == 32, "the header keeps the records 32-byte aligned");
+
+    const char MAGIC[8] = { 'C', 'B', 'P', 'O', 'S', 'D', 'B', '\0' };
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    const uint32_t VERSION = 1;
+
+    // The header count of a file still being written: close() replaces it, so a reader can tell an unclosed file
+    // from an empty one
+    const uint64_t INCOMPLETE = UINT64_MAX;
+}
+
+/**
+ * @class PositionDatabaseWriter
+ * @brief Appends PackedPosition records to a new database file through a buffered stream
+ */
+class PositionDatabaseWriter {
+    private:
+        std::FILE* file_;
+        uint64_t count_;
+
+    public:
+        PositionDatabaseWriter();
+
+        /**
+         * @brief Closes the file (see close())
+         */
+        ~PositionDatabaseWriter();
+
+        PositionDatabaseWriter(const PositionDatabaseWriter&) = delete;
+        PositionDatabaseWriter& operator=(const PositionDatabaseWriter&) = delete;
+
+        /**
+         * @brief Creates (or truncates) a database file and writes a header marked incomplete (see close())
+         * @param error If not null, receives a description of the problem on failure
+         * @return False if the file could not be created
+         */
+        bool open(const std::string& path, std::string* error = nullptr);
+
+        /**
+         * @brief Appends one record
+         * @return False if no file is open or the write failed
+         */
+        bool append(const PackedPosition& record);
+
+        /**
+         * @brief Packs a board's position and appends it
+         * @return False if the position cannot be packed (see PackedPosition::pack()) or the write failed
+         */
+        bool append(const ChessBoard& board);
+
+        /**
+         * @brief Writes the final record count into the header and closes the file
+         * @return False if the file could not be completed, or none was open
+         */
+        bool close();
+
+        uint64_t count() const { return count_; }
+};
+
+/**
+ * @class PositionDatabaseReader
+ * @brief Read-only, memory-mapped view of a database file
+ */
+class PositionDatabaseReader {
+    private:
+        void* mapping_;
+        size_t mappedBytes_;
+        const PackedPosition* records_;
+        size_t count_;
+
+    public:
+        PositionDatabaseReader();
+
+        /**
+         * @brief Unmaps the file (see close())
+         */
+        ~PositionDatabaseReader();
+
+        PositionDatabaseReader(const PositionDatabaseReader&) = delete;
+        PositionDatabaseReader& operator=(const PositionDatabaseReader&) = delete;
+
+        /**
+         * @brief Maps a database file, checking its header
+         * @param error If not null, receives a description of the problem on failure
+         * @return False if the file cannot be mapped or is not a complete database of this format
+         */
+        bool open(const std::string& path, std::string* error = nullptr);
+
+        /**
+         * @brief Unmaps the file. References to records obtained earlier become invalid.
+         */
+        void close();
+
+        size_t size() const { return count_; }
+
+        /**
+         * @brief Gets a record in place, without copying it
+         * @pre index < size()
+         */
+        const PackedPosition& operator[](const size_t& index) const { return records_[index]; }
+
+        /**
+         * @brief Sets up `board` with record `index` (see PackedPosition::unpack())
+         * @pre index < size()
+         */
+        bool decode(const size_t& index, ChessBoard& board, std::string* error = nullptr) const {
+            return records_[index].unpack(board, error);
+        }
+
+        /**
+         * @brief Visits every record, splitting the file across worker threads
+         * @param threads The number of threads, including the calling one. Values below 1 are treated as 1.
+         * @param visit Called once per record with the record, its index and the number of the thread that visits it
+         *        (0 .. threads - 1), so callers can keep per-thread state such as a scratch ChessBoard without locking
+         * @note Threads claim blocks of consecutive records in file order, so each one streams through the mapping
+         *       sequentially and fast and slow blocks balance out. The order of the calls is otherwise unspecified.
+         */
+        void scan(const int& threads,
+                  const std::function<void(const PackedPosition& record, const size_t& index, const int& thread)>& visit) const;
+};
@@ -0,0 +1,41 @@
+/**
+ * @class Prng
+ * @brief A small, deterministic xorshift64* pseudo-random number generator
+ *
+ * The engine seeds its lookup tables (magic numbers, hashing keys) from this generator
+ * so that every build and every run produces the exact same tables.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class Prng {
+    private:
+        uint64_t state_; // Must never be 0, or the generator gets stuck
+
+    public:
+        /**
+         * @brief Constructs a generator from a seed
+         * @param seed A non-zero seed. A zero seed is replaced with a fixed non-zero constant.
+         */
+        explicit Prng(const uint64_t& seed) : state_{seed ? seed : 0x9E3779B97F4A7C15ULL} {}
+
+        /**
+         * @brief Gets the next 64-bit pseudo-random value
+         */
+        uint64_t next() {
+            state_ ^= state_ >> 12;
+            state_ ^= state_ << 25;
+            state_ ^= state_ >> 27;
+            return state_ * 2685821657736338717ULL;
+        }
+
+        /**
+         * @brief Gets a pseudo-random value with roughly 1/8th of its bits set
+         * @note Sparse candidates converge much faster when searching for magic numbers
+         */
+        uint64_t nextSparse() {
+            return next() & next() & next();
+        }
+};
@@ -0,0 +1,164 @@
+/**
+ * @class QueenSolver
+ * @brief Solves the N-queens puzzle on an N x N board (4 <= N <= 32), specialized at compile time for each N
+ *
+ * Queens are placed column by column like ChessBoard::queenHelper(), but the squares attacked by the queens placed
+ * so far live in three BoardSize<N>::LineMask integers (rows, rising and falling diagonals) instead of being asked of
+ * Queen pieces, and each column is its own template instantiation, so the compiler sees the board size and the
+ * depth everywhere and unrolls the search completely. For N = 8, findAll() returns the same boards in the same order
+ * as ChessBoard::findAllQueenPlacements(). findAllFlat() returns the same boards as FlatBoard<N>s, which need no
+ * allocation of their own.
+ *
+ * The overloads taking a CancellationToken poll it while they run (at every node except in the last
+ * UNPOLLED_COLUMNS columns, whose subtrees are tiny), stop soon after it is raised and report that they were stopped.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "BoardSize.hpp"
+#include "CancellationToken.hpp"
+#include "FlatBoard.hpp"
+
+template <int N>
+class QueenSolver {
+    public:
+        typedef typename BoardSize<N>::LineMask Mask;
+        typedef std::vector<std::vector<char>> CharacterBoard;
+
+        static constexpr int UNPOLLED_COLUMNS = 6;
+
+    private:
+        static constexpr Mask FULL = BoardSize<N>::FULL_LINE;
+
+        /**
+         * @brief Places a queen in each free row of column Col in turn, and recurses into the next column
+         * @param rows Rows already holding a queen
+         * @param rising Rows of this column attacked along a rising diagonal (moving up one row per column)
+         * @param falling Rows of this column attacked along a falling diagonal
+         * @param queenRows The row of the queen in each column before Col
+         * @param visit Called with queenRows for every complete placement
+         * @return False if the token stopped the search
+         */
+        template <int Col, typename Visit>
+        static bool place(const Mask& rows, const Mask& rising, const Mask& falling, uint8_t* queenRows, Visit& visit,
+                          const CancellationToken* token) {
+            if constexpr (Col == N) {
+                visit(queenRows);
+                return true;
+            } else {
+                if constexpr (N - Col > UNPOLLED_COLUMNS) {
+                    if (token && token->stopRequested()) { return false; }
+                }
+                for (Mask free = Mask(FULL & ~(rows | rising | falling)); free; free = Mask(free & (free - 1))) {
+                    Mask bit = Mask(free & (0 - free));
+                    queenRows[Col] = uint8_t(__builtin_ctz(bit));
+                    if (!place<Col + 1>(Mask(rows | bit), Mask((rising | bit) << 1), Mask((falling | bit) >> 1), queenRows, visit, token)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        }
+
+        /**
+         * @brief Runs the search with the first column's queen restricted to the given rows
+         */
+        template <typename Visit>
+        static bool search(const Mask& firstRows, Visit& visit, const CancellationToken* token) {
+            uint8_t queenRows[N];
+            if (token && token->stopRequested()) { return false; }
+            for (Mask free = firstRows; free; free = Mask(free & (free - 1))) {
+                Mask bit = Mask(free & (0 - free));
+                queenRows[0] = uint8_t(__builtin_ctz(bit));
+                if (!place<1>(bit, Mask(bit << 1), Mask(bit >> 1), queenRows, visit, token)) { return false; }
+            }
+            return true;
+        }
+
+        static void build(const uint8_t* queenRows, CharacterBoard& board) {
+            board.assign(N, std::vector<char>(N, '*'));
+            for (int col = 0; col < N; col++) { board[queenRows[col]][col] = 'Q'; }
+        }
+
+        static void build(const uint8_t* queenRows, FlatBoard<N>& board) {
+            for (int col = 0; col < N; col++) { board(queenRows[col], col) = 'Q'; }
+        }
+
+        template <typename Board>
+        static bool collect(std::vector<Board>& solutions, const CancellationToken* token) {
+            solutions.clear();
+            auto record = [&solutions](const uint8_t* queenRows) {
+                solutions.emplace_back();
+                build(queenRows, solutions.back());
+            };
+            return search(FULL, record, token);
+        }
+
+        /**
+         * @brief Counts the placements using the board's mirror symmetry: every placement with the first queen in the
+         *        lower half of the first column has a mirror image with it in the upper half
+         */
+        static bool tally(uint64_t& solutions, const CancellationToken* token) {
+            uint64_t found = 0;
+            auto countOne = [&found](const uint8_t*) { found++; };
+            Mask lowerHalf = Mask((Mask(1) << (N / 2)) - 1);
+            bool finished = search(lowerHalf, countOne, token);
+            found *= 2;
+            if (finished && N % 2 == 1) { finished = search(Mask(Mask(1) << (N / 2)), countOne, token); }
+            solutions = found;
+            return finished;
+        }
+
+    public:
+        /**
+         * @brief Finds every placement of N non-attacking queens
+         * @return One CharacterBoard per placement: N rows of N cells, 'Q' for a queen and '*' otherwise
+         */
+        static std::vector<CharacterBoard> findAll() {
+            std::vector<CharacterBoard> solutions;
+            collect(solutions, nullptr);
+            return solutions;
+        }
+
+        /**
+         * @brief Finds every placement, stopping early if the token is raised
+         * @param solutions Receives the placements, or the ones found before the token was raised
+         * @return True if the search finished, false if the token stopped it
+         */
+        static bool findAll(const CancellationToken& token, std::vector<CharacterBoard>& solutions) { return collect(solutions, &token); }
+
+        /**
+         * @brief Finds every placement of N non-attacking queens as flat boards
+         * @return One FlatBoard per placement, in the same order as findAll()
+         */
+        static std::vector<FlatBoard<N>> findAllFlat() {
+            std::vector<FlatBoard<N>> solutions;
+            collect(solutions, nullptr);
+            return solutions;
+        }
+
+        /**
+         * @brief Finds every placement as flat boards, stopping early if the token is raised
+         * @param solutions Receives the placements, or the ones found before the token was raised
+         * @return True if the search finished, false if the token stopped it
+         */
+        static bool findAllFlat(const CancellationToken& token, std::vector<FlatBoard<N>>& solutions) { return collect(solutions, &token); }
+
+        /**
+         * @brief Counts the placements of N non-attacking queens without building them
+         */
+        static uint64_t count() {
+            uint64_t solutions = 0;
+            tally(solutions, nullptr);
+            return solutions;
+        }
+
+        /**
+         * @brief Counts the placements, stopping early if the token is raised
+         * @param solutions Receives the count (only meaningful if the search finished)
+         * @return True if the search finished, false if the token stopped it
+         */
+        static bool count(const CancellationToken& token, uint64_t& solutions) { return tally(solutions, &token); }
+};
@@ -0,0 +1,59 @@
+#include "Scheduler.hpp"
+
+/**
+ * @brief Starts the workers
+ * @param threads The number of worker threads. Values below 1 are treated as 1.
+ */
+Scheduler::Scheduler(const int& threads) : submitted_{0}, closing_{false} {
+    int count = threads < 1 ? 1 : threads;
+    for (int i = 0; i < count; i++) { workers_.emplace_back([this]() { work(); }); }
+}
+
+/**
+ * @brief Runs the jobs still queued, then joins the workers
+ */
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        closing_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) { worker.join(); }
+}
+
+/**
+ * @brief Queues a job and wakes a worker
+ */
+void Scheduler::enqueue(const Priority& priority, std::function<void()> run) {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        queue_.push({ int(priority), submitted_++, std::move(run) });
+    }
+    wake_.notify_one();
+}
+
+/**
+ * @brief Each worker's loop: takes the best queued job and runs it, until the pool closes and the queue is empty
+ * @note Jobs run outside the lock; packaged_task stores anything they throw in their future
+ */
+void Scheduler::work() {
+    while (true) {
+        std::function<void()> run;
+        {
+            std::unique_lock<std::mutex> guard(lock_);
+            wake_.wait(guard, [this]() { return closing_ || !queue_.empty(); });
+            if (queue_.empty()) { return; }
+            run = std::move(const_cast<Job&>(queue_.top()).run);
+            queue_.pop();
+        }
+        run();
+    }
+}
+
+/**
+ * @brief Gets the number of jobs waiting for a worker
+ */
+size_t Scheduler::queued() {
+    std::lock_guard<std::mutex> guard(lock_);
+    return queue_.size();
+}
@@ -0,0 +1,113 @@
+/**
+ * @class Scheduler
+ * @brief A fixed pool of worker threads running submitted jobs by priority, each with a future for its result
+ *
+ * Jobs are functions of a CancellationToken. Workers always take the highest-priority queued job, oldest first
+ * within a priority. A job whose token is already raised when a worker takes it is not run at all; its future
+ * throws Scheduler::Cancelled instead. Jobs that do run should poll the token (the ChessBoard solvers accept one)
+ * so that a cancelled or overdue job frees its worker for the next one, eg. a long solver job submitted with a
+ * deadline at LOW priority next to short HIGH-priority requests.
+ *
+ * The destructor runs every job still queued, then joins the workers; raise the jobs' tokens first to skip them.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "CancellationToken.hpp"
+
+class Scheduler {
+    public:
+        enum Priority {
+            LOW = 0,
+            NORMAL = 1,
+            HIGH = 2
+        };
+
+        /**
+         * @brief Thrown by the future of a job that was skipped because its token was raised before it started
+         */
+        class Cancelled : public std::runtime_error {
+            public:
+                Cancelled() : std::runtime_error("job cancelled before it started") {}
+        };
+
+    private:
+        struct Job {
+            int priority;
+            uint64_t sequence;             // Submission order, for first-in first-out within a priority
+            std::function<void()> run;
+
+            bool operator<(const Job& other) const {
+                return priority != other.priority ? priority < other.priority : sequence > other.sequence;
+            }
+        };
+
+        std::mutex lock_;
+        std::condition_variable wake_;
+        std::priority_queue<Job> queue_;
+        uint64_t submitted_;
+        bool closing_;
+        std::vector<std::thread> workers_;
+
+        /**
+         * @brief Queues a job and wakes a worker
+         */
+        void enqueue(const Priority& priority, std::function<void()> run);
+
+        /**
+         * @brief Each worker's loop: takes the best queued job and runs it, until the pool closes and the queue is empty
+         */
+        void work();
+
+    public:
+        /**
+         * @brief Starts the workers
+         * @param threads The number of worker threads. Values below 1 are treated as 1.
+         */
+        explicit Scheduler(const int& threads);
+
+        /**
+         * @brief Runs the jobs still queued, then joins the workers
+         */
+        ~Scheduler();
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        /**
+         * @brief Queues a job
+         * @param job Called as job(token) on a worker thread
+         * @param priority Queued jobs of a higher priority start first
+         * @param token Passed to the job. If it is raised before a worker takes the job, the job is skipped.
+         * @return The job's result, or its exception, or Cancelled if it was skipped
+         */
+        template <typename Function>
+        auto submit(Function job, const Priority& priority = NORMAL, const CancellationToken& token = CancellationToken())
+            -> std::future<decltype(job(token))> {
+            typedef decltype(job(token)) Result;
+            auto task = std::make_shared<std::packaged_task<Result()>>([job, token]() mutable -> Result {
+                if (token.stopRequested()) { throw Cancelled(); }
+                return job(token);
+            });
+            std::future<Result> future = task->get_future();
+            enqueue(priority, [task]() { (*task)(); });
+            return future;
+        }
+
+        int threads() const { return int(workers_.size()); }
+
+        /**
+         * @brief Gets the number of jobs waiting for a worker
+         */
+        size_t queued();
+};
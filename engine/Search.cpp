@@ -0,0 +1,328 @@
+#include "Search.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    // How many nodes pass between checks of the clock and stop signal
+    const uint64_t CHECK_INTERVAL = 1024;
+
+    // Lazy-SMP depth staggering: helper i skips depths in blocks of SKIP_SIZE[i], offset by SKIP_PHASE[i]
+    const int SKIP_SIZE[] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    const int SKIP_PHASE[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+    const int SKIP_PATTERNS = sizeof(SKIP_SIZE) / sizeof(SKIP_SIZE[0]);
+}
+
+static_assert(Search::MAX_PLY == MoveOrdering::MAX_PLY, "killer table depth must match the search depth");
+
+/**
+ * @brief Constructs a search that caches its results in the given table
+ */
+Search::Search(TranspositionTable& table)
+    : table_{table}, ownStop_{false}, stop_{&ownStop_}, nodes_{0}, nodeLimit_{0}, hasDeadline_{false}, aborted_{false}, helperIndex_{0}, sharedGeneration_{false},
+      cutoffs_{0}, firstMoveCutoffs_{0} {
+    std::fill(pvLength_, pvLength_ + MAX_PLY, 0);
+}
+
+/**
+ * @brief Gets the material value of a piece kind in centipawns: 100 x the piece's ChessPiece::size()
+ */
+int Search::pieceValue(const int& kind) {
+    return Evaluation::pieceValue(kind);
+}
+
+/**
+ * @brief Scores a position from the side to move's point of view (see ChessBoard::evaluate())
+ */
+int Search::evaluate(const ChessBoard& board) {
+    return board.evaluate();
+}
+
+int64_t Search::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_).count();
+}
+
+/**
+ * @brief Checks whether a helper search skips this iteration, so that helpers spread over different depths
+ */
+bool Search::skipsDepth(const int& depth) const {
+    if (helperIndex_ <= 0) { return false; }
+    int pattern = (helperIndex_ - 1) % SKIP_PATTERNS;
+    return ((depth + SKIP_PHASE[pattern]) / SKIP_SIZE[pattern]) % 2 != 0;
+}
+
+/**
+ * @brief Counts a node and, every so often, checks the stop signal, node limit and deadline
+ * @return True if the search has to unwind now
+ */
+bool Search::checkAbort() {
+    uint64_t count = nodes_.load(std::memory_order_relaxed) + 1;
+    nodes_.store(count, std::memory_order_relaxed);
+
+    if (aborted_) { return true; }
+    if (nodeLimit_ && count >= nodeLimit_) { aborted_ = true; }
+    if (count % CHECK_INTERVAL == 0) {
+        if (stop_->load(std::memory_order_relaxed)) { aborted_ = true; }
+        if (hasDeadline_ && std::chrono::steady_clock::now() >= deadline_) { aborted_ = true; }
+    }
+    return aborted_;
+}
+
+/**
+ * @brief Converts mate scores between "distance from the root" and "distance from this node" for the table
+ */
+int Search::scoreToTable(const int& score, const int& ply) {
+    if (score >= MATE_BOUND) { return score + ply; }
+    if (score <= -MATE_BOUND) { return score - ply; }
+    return score;
+}
+
+int Search::scoreFromTable(const int& score, const int& ply) {
+    if (score >= MATE_BOUND) { return score - ply; }
+    if (score <= -MATE_BOUND) { return score + ply; }
+    return score;
+}
+
+/**
+ * @brief Searches captures (and promotions) only, until the position is quiet, so that the static evaluation
+ *        is never taken in the middle of an exchange. When in check every evasion is searched instead.
+ */
+int Search::quiescence(ChessBoard& board, int alpha, int beta, const int& ply) {
+    pvLength_[ply] = ply;
+    if (checkAbort()) { return 0; }
+    if (ply >= MAX_PLY - 1) { return evaluate(board); }
+
+    bool inCheck = board.isCheck();
+    int best = -INFINITE_SCORE;
+    if (!inCheck) {
+        // Standing pat: the side to move can usually do at least as well as the current material
+        best = evaluate(board);
+        if (best >= beta) { return best; }
+        alpha = std::max(alpha, best);
+    }
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    if (moves.empty()) { return inCheck ? -MATE_SCORE + ply : 0; }
+
+    int scores[MoveList::CAPACITY];
+    ordering_.score(board, moves, Move(), ply, scores);
+    for (int i = 0; i < moves.size(); i++) {
+        Move move = MoveOrdering::pickNext(moves, scores, i);
+        if (!inCheck) {
+            if (!move.isCapture() && !move.isPromotion()) { continue; }
+            // Captures that lose material by exchange cannot raise the stand-pat score (score() already ran the exchange)
+            if (MoveOrdering::losesExchange(scores[i])) { continue; }
+        }
+
+        board.makeMove(move);
+        int score = -quiescence(board, -beta, -alpha, ply + 1);
+        board.unmakeMove();
+        if (aborted_) { return 0; }
+
+        if (score > best) {
+            best = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) { break; }
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Fail-soft negamax alpha-beta search to the given depth
+ */
+int Search::negamax(ChessBoard& board, int depth, int alpha, int beta, const int& ply) {
+    bool inCheck = board.isCheck();
+    if (inCheck) { depth++; }  // Never stop searching in the middle of a check
+    if (depth <= 0) { return quiescence(board, alpha, beta, ply); }
+
+    pvLength_[ply] = ply;
+    if (checkAbort()) { return 0; }
+
+    if (ply > 0) {
+        if (board.isDraw()) { return 0; }
+
+        // A mate found closer to the root already beats anything this node could return
+        alpha = std::max(alpha, -MATE_SCORE + ply);
+        beta = std::min(beta, MATE_SCORE - ply - 1);
+        if (alpha >= beta) { return alpha; }
+    }
+    if (ply >= MAX_PLY - 1) { return evaluate(board); }
+
+    TranspositionTable::Entry entry;
+    Move tableMove;
+    if (table_.probe(board.hash(), entry)) {
+        tableMove = entry.move;
+        int score = scoreFromTable(entry.score, ply);
+        if (ply > 0 && entry.depth >= depth &&
+            (entry.bound == TranspositionTable::BOUND_EXACT ||
+             (entry.bound == TranspositionTable::BOUND_LOWER && score >= beta) ||
+             (entry.bound == TranspositionTable::BOUND_UPPER && score <= alpha))) {
+            return score;
+        }
+    }
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    if (moves.empty()) { return inCheck ? -MATE_SCORE + ply : 0; }
+
+    int scores[MoveList::CAPACITY];
+    ordering_.score(board, moves, tableMove, ply, scores);
+    Move quiets[MoveList::CAPACITY];
+    int quietCount = 0;
+
+    int originalAlpha = alpha;
+    int best = -INFINITE_SCORE;
+    Move bestMove;
+    for (int i = 0; i < moves.size(); i++) {
+        Move move = MoveOrdering::pickNext(moves, scores, i);
+        board.makeMove(move);
+        int score = -negamax(board, depth - 1, -beta, -alpha, ply + 1);
+        board.unmakeMove();
+        if (aborted_) { return 0; }
+
+        if (score > best) {
+            best = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+
+                // This move heads the line; the child's line follows it
+                pv_[ply][ply] = move;
+                for (int i = ply + 1; i < pvLength_[ply + 1]; i++) { pv_[ply][i] = pv_[ply + 1][i]; }
+                pvLength_[ply] = std::max(pvLength_[ply + 1], ply + 1);
+
+                if (alpha >= beta) {
+                    cutoffs_++;
+                    if (i == 0) { firstMoveCutoffs_++; }
+                    if (!move.isCapture() && !move.isPromotion()) {
+                        ordering_.updateQuiet(board, move, depth, ply, quiets, quietCount);
+                    }
+                    break;
+                }
+            }
+        }
+        if (!move.isCapture() && !move.isPromotion()) { quiets[quietCount++] = move; }
+    }
+
+    int bound = (best >= beta) ? TranspositionTable::BOUND_LOWER :
+                (best > originalAlpha) ? TranspositionTable::BOUND_EXACT : TranspositionTable::BOUND_UPPER;
+    table_.store(board.hash(), bestMove, scoreToTable(best, ply), 0, depth, bound);
+    return best;
+}
+
+void Search::publish(const SearchResult& result) {
+    {
+        std::lock_guard<std::mutex> lock(resultMutex_);
+        best_ = result;
+    }
+    if (onIteration_) { onIteration_(result); }
+}
+
+/**
+ * @brief Gets the best line found so far. Safe to call from any thread, including while run() is going.
+ */
+SearchResult Search::bestSoFar() const {
+    std::lock_guard<std::mutex> lock(resultMutex_);
+    SearchResult result = best_;
+    result.nodes = nodes();
+    return result;
+}
+
+/**
+ * @brief Searches the position for the best move
+ * @param board The position. It is played on during the search, but left as it was on return.
+ * @param limits When to stop
+ * @return The deepest completed iteration. If not even depth 1 finished, the first legal move with depth 0.
+ */
+SearchResult Search::run(ChessBoard& board, const SearchLimits& limits) {
+    start_ = std::chrono::steady_clock::now();
+    hasDeadline_ = limits.movetimeMs > 0;
+    deadline_ = start_ + std::chrono::milliseconds(limits.movetimeMs);
+    nodeLimit_ = limits.nodes;
+    nodes_.store(0);
+    aborted_ = false;
+    cutoffs_ = 0;
+    firstMoveCutoffs_ = 0;
+    ordering_.age();
+    if (stop_ == &ownStop_) { ownStop_.store(false); }
+    if (!sharedGeneration_) { table_.newSearch(); }
+
+    int maxDepth = (limits.depth > 0) ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+
+    MoveList rootMoves;
+    board.generateLegalMoves(rootMoves);
+    SearchResult fallback;
+    if (rootMoves.empty()) {
+        fallback.score = board.isCheck() ? -MATE_SCORE : 0;
+    } else {
+        fallback.bestMove = rootMoves[0];
+        fallback.pv.push_back(rootMoves[0]);
+    }
+    {
+        std::lock_guard<std::mutex> lock(resultMutex_);
+        best_ = fallback;
+    }
+    if (rootMoves.empty()) { return fallback; }
+
+    int score = 0;
+    uint64_t previousIterationNodes = 0;
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        if (depth < maxDepth && skipsDepth(depth)) { continue; }
+
+        // Aspiration window: expect a score close to the last iteration's, and widen the window on a miss
+        int delta = ASPIRATION_WINDOW;
+        int alpha = -INFINITE_SCORE;
+        int beta = INFINITE_SCORE;
+        if (depth >= 4) {
+            alpha = std::max(score - delta, -INFINITE_SCORE);
+            beta = std::min(score + delta, INFINITE_SCORE);
+        }
+
+        uint64_t iterationStart = nodes();
+        int result = 0;
+        while (true) {
+            result = negamax(board, depth, alpha, beta, 0);
+            if (aborted_) { break; }
+
+            if (result <= alpha) {
+                alpha = std::max(result - delta, -INFINITE_SCORE);
+            } else if (result >= beta) {
+                beta = std::min(result + delta, INFINITE_SCORE);
+            } else {
+                break;
+            }
+            delta *= 2;
+        }
+        if (aborted_) { break; }
+        score = result;
+        uint64_t iterationNodes = nodes() - iterationStart;
+
+        SearchResult iteration;
+        iteration.bestMove = pv_[0][0];
+        iteration.score = score;
+        iteration.depth = depth;
+        iteration.pv.assign(pv_[0], pv_[0] + pvLength_[0]);
+        iteration.nodes = nodes();
+        iteration.elapsedMs = elapsedMs();
+        iteration.cutoffs = cutoffs_;
+        iteration.firstMoveCutoffs = firstMoveCutoffs_;
+        if (previousIterationNodes) { iteration.branchingFactor = double(iterationNodes) / double(previousIterationNodes); }
+        previousIterationNodes = iterationNodes;
+        publish(iteration);
+
+        // A forced mate will not get any shorter by searching deeper
+        if (std::abs(score) >= MATE_BOUND && MATE_SCORE - std::abs(score) <= depth) { break; }
+
+        // Another iteration takes several times longer than this one, so do not start one that cannot finish
+        if (hasDeadline_ && elapsedMs() * 2 >= limits.movetimeMs) { break; }
+    }
+
+    SearchResult result = bestSoFar();
+    result.elapsedMs = elapsedMs();
+    result.cutoffs = cutoffs_;
+    result.firstMoveCutoffs = firstMoveCutoffs_;
+    return result;
+}
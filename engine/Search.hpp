@@ -0,0 +1,175 @@
+/**
+ * @class Search
+ * @brief Best-move search over a ChessBoard: negamax with alpha-beta pruning, iterative deepening,
+ *        aspiration windows and a principal variation
+ *
+ * Each iteration searches one ply deeper than the last, starting from a narrow window around the previous score
+ * and widening it when the score falls outside. Results are shared with later iterations (and other searches)
+ * through a TranspositionTable. The search stops at a depth limit, a node limit, a wall-clock deadline, or when
+ * stop() is called, and always answers with the deepest completed iteration. bestSoFar() may be read from any
+ * thread while the search is running.
+ *
+ * Scores are in centipawns from the side to move's point of view; leaves are scored by ChessBoard::evaluate().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "../ChessBoard.hpp"
+#include "MoveOrdering.hpp"
+#include "TranspositionTable.hpp"
+
+/**
+ * @brief When to stop searching. A limit of 0 means "no limit".
+ */
+struct SearchLimits {
+    int depth;              // Maximum iteration depth, in plies
+    uint64_t nodes;         // Maximum number of nodes
+    int64_t movetimeMs;     // Wall-clock budget in milliseconds
+
+    SearchLimits() : depth{0}, nodes{0}, movetimeMs{0} {}
+};
+
+/**
+ * @brief The outcome of a search, or of its latest completed iteration
+ */
+struct SearchResult {
+    Move bestMove;          // Null only if the root position has no legal move
+    int score;              // Centipawns for the side to move, or +/- (MATE_SCORE - plies) for forced mates
+    int depth;              // Deepest completed iteration
+    std::vector<Move> pv;   // Principal variation, starting with bestMove
+    uint64_t nodes;
+    int64_t elapsedMs;
+
+    // Move ordering statistics of the run so far
+    double branchingFactor; // Nodes of the last iteration over nodes of the one before it
+    uint64_t cutoffs;       // Beta cutoffs in the main search (not quiescence)
+    uint64_t firstMoveCutoffs;  // ... of which on the first move tried
+
+    SearchResult() : score{0}, depth{0}, nodes{0}, elapsedMs{0}, branchingFactor{0}, cutoffs{0}, firstMoveCutoffs{0} {}
+};
+
+class Search {
+    public:
+        static constexpr int MAX_PLY = 128;
+        static constexpr int INFINITE_SCORE = 32001;
+        static constexpr int MATE_SCORE = 32000;
+        static constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY;   // Scores beyond this are forced mates
+        static constexpr int ASPIRATION_WINDOW = 50;
+
+    private:
+        TranspositionTable& table_;
+        std::atomic<bool> ownStop_;
+        std::atomic<bool>* stop_;          // Points at ownStop_ unless the search shares a stop signal
+
+        std::atomic<uint64_t> nodes_;
+        uint64_t nodeLimit_;
+        bool hasDeadline_;
+        std::chrono::steady_clock::time_point start_;
+        std::chrono::steady_clock::time_point deadline_;
+        bool aborted_;
+        int helperIndex_;                  // 0 for a lone or main search; helpers skip some iteration depths
+        bool sharedGeneration_;            // If set, the caller starts the table's generation instead of run()
+
+        MoveOrdering ordering_;
+        uint64_t cutoffs_;
+        uint64_t firstMoveCutoffs_;
+
+        // Triangular principal variation table: pv_[ply] holds the line from `ply` onwards
+        Move pv_[MAX_PLY][MAX_PLY];
+        int pvLength_[MAX_PLY];
+
+        mutable std::mutex resultMutex_;
+        SearchResult best_;
+        std::function<void(const SearchResult&)> onIteration_;
+
+        /**
+         * @brief Counts a node and, every so often, checks the stop signal, node limit and deadline
+         * @return True if the search has to unwind now
+         */
+        bool checkAbort();
+
+        int negamax(ChessBoard& board, int depth, int alpha, int beta, const int& ply);
+        int quiescence(ChessBoard& board, int alpha, int beta, const int& ply);
+
+        /**
+         * @brief Converts mate scores between "distance from the root" and "distance from this node" for the table
+         */
+        static int scoreToTable(const int& score, const int& ply);
+        static int scoreFromTable(const int& score, const int& ply);
+
+        /**
+         * @brief Checks whether a helper search skips this iteration, so that helpers spread over different depths
+         */
+        bool skipsDepth(const int& depth) const;
+
+        int64_t elapsedMs() const;
+        void publish(const SearchResult& result);
+
+    public:
+        /**
+         * @brief Constructs a search that caches its results in the given table
+         */
+        explicit Search(TranspositionTable& table);
+
+        /**
+         * @brief Searches the position for the best move
+         * @param board The position. It is played on during the search, but left as it was on return.
+         * @param limits When to stop
+         * @return The deepest completed iteration. If not even depth 1 finished, the first legal move with depth 0.
+         */
+        SearchResult run(ChessBoard& board, const SearchLimits& limits);
+
+        /**
+         * @brief Asks a running search to stop as soon as possible. Safe to call from any thread.
+         */
+        void stop() { stop_->store(true); }
+
+        /**
+         * @brief Makes the search use (and never reset) an external stop signal, eg. one shared by several searches
+         */
+        void shareStopSignal(std::atomic<bool>& signal) { stop_ = &signal; }
+
+        /**
+         * @brief Makes this search a Lazy-SMP helper. Helper i > 0 skips a staggered subset of the iteration depths,
+         *        so helpers run ahead of the main search and fill the shared table; 0 searches every depth.
+         */
+        void setHelperIndex(const int& index) { helperIndex_ = index; }
+
+        /**
+         * @brief Leaves TranspositionTable::newSearch() to the caller, which must call it before this or any other
+         *        search on the table starts (eg. LazySmp, before it spawns its threads)
+         * @note Otherwise run() starts a new generation itself, which is only safe while no other thread uses the table
+         */
+        void shareTableGeneration() { sharedGeneration_ = true; }
+
+        /**
+         * @brief Gets the best line found so far. Safe to call from any thread, including while run() is going.
+         */
+        SearchResult bestSoFar() const;
+
+        /**
+         * @brief Gets the number of nodes searched so far by the current (or last) run. Safe to call from any thread.
+         */
+        uint64_t nodes() const { return nodes_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Sets a function to call after every completed iteration (eg. to print UCI "info" lines)
+         */
+        void onIteration(const std::function<void(const SearchResult&)>& callback) { onIteration_ = callback; }
+
+        /**
+         * @brief Gets the material value of a piece kind in centipawns: 100 x the piece's ChessPiece::size()
+         */
+        static int pieceValue(const int& kind);
+
+        /**
+         * @brief Scores a position from the side to move's point of view (see ChessBoard::evaluate())
+         */
+        static int evaluate(const ChessBoard& board);
+};
@@ -0,0 +1,515 @@
+#include "Tablebase.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Attacks.hpp"
+#include "../Transform.hpp"
+
+namespace {
+    const size_t NO_INDEX = std::numeric_limits<size_t>::max();
+    const int SYMMETRIES = 8;
+    const char PIECE_LETTERS[PIECE_KIND_COUNT + 1] = "PNBRQK";
+
+    // Escape counter of a weak-to-move position that can reach a draw, so it is never lost
+    const uint8_t DRAWN = 255;
+
+    // Positions handed to a worker at a time
+    const size_t CHUNK = 1024;
+
+    /**
+     * @brief The file header. The two tables follow it: STRONG_TO_MOVE first, then WEAK_TO_MOVE.
+     */
+    struct FileHeader {
+        char magic[8];
+        uint32_t byteOrderMark;
+        uint32_t version;
+        uint8_t kinds[4];                     // The strong side's extra pieces, padded with NO_PIECE_KIND
+        uint32_t maxPlies;
+        uint64_t positions;                   // Entries per table
+    };
+
+    static_assert(sizeof(FileHeader) == 32, "the header keeps the tables 32-byte aligned");
+
+    const char MAGIC[8] = { 'C', 'B', 'T', 'B', 'A', 'S', 'E', '\0' };
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    const uint32_t VERSION = 1;
+
+    /**
+     * @brief Square permutations for the eight symmetries of the board, and the canonical King placements
+     */
+    struct Symmetry {
+        uint8_t image[SYMMETRIES][Bitboards::SQUARE_COUNT];      // image[t][sq]: the square symmetry t sends sq to
+        int16_t kingPair[Bitboards::SQUARE_COUNT][Bitboards::SQUARE_COUNT];   // Canonical pair index, or -1
+        uint8_t pairSquares[Tablebase::KING_PAIRS][2];
+
+        Symmetry() {
+            // The four rotations, each also flipped, of a board of square numbers: the same transformations as
+            // ChessBoard::getAllTransformations(). Cell (row, col) of a transformed board names the square moved there.
+            std::vector<std::vector<int>> rotated(8, std::vector<int>(8));
+            for (int row = 0; row < 8; row++) {
+                for (int col = 0; col < 8; col++) { rotated[row][col] = Bitboards::square(row, col); }
+            }
+            for (int turn = 0; turn < 4; turn++) {
+                record(2 * turn, rotated);
+                record(2 * turn + 1, Transform::flipAcrossVertical(rotated));
+                rotated = Transform::rotate(rotated);
+            }
+
+            // The strong King goes in the triangle col <= 3, row <= col. On its diagonal, the reflection across that
+            // diagonal still applies, so the weak King must be on or below it too.
+            int pairs = 0;
+            for (int strong = 0; strong < Bitboards::SQUARE_COUNT; strong++) {
+                for (int weak = 0; weak < Bitboards::SQUARE_COUNT; weak++) {
+                    kingPair[strong][weak] = -1;
+                    int row = Bitboards::rowOf(strong);
+                    int col = Bitboards::colOf(strong);
+                    if (col > 3 || row > col || weak == strong || (Attacks::king(strong) & Bitboards::squareBit(weak))) { continue; }
+                    if (row == col && Bitboards::rowOf(weak) > Bitboards::colOf(weak)) { continue; }
+                    pairSquares[pairs][0] = uint8_t(strong);
+                    pairSquares[pairs][1] = uint8_t(weak);
+                    kingPair[strong][weak] = int16_t(pairs++);
+                }
+            }
+        }
+
+        void record(const int& t, const std::vector<std::vector<int>>& board) {
+            for (int row = 0; row < 8; row++) {
+                for (int col = 0; col < 8; col++) { image[t][board[row][col]] = uint8_t(Bitboards::square(row, col)); }
+            }
+        }
+    };
+
+    const Symmetry& symmetry() {
+        static const Symmetry SYMMETRY;
+        return SYMMETRY;
+    }
+
+    /**
+     * @brief Runs work(thread) on `threads` threads, the calling one included, and waits for all of them
+     */
+    void runWorkers(const int& threads, const std::function<void(const int&)>& work) {
+        std::vector<std::thread> helpers;
+        for (int t = 1; t < threads; t++) { helpers.emplace_back(work, t); }
+        work(0);
+        for (std::thread& helper : helpers) { helper.join(); }
+    }
+
+    bool fail(std::string* error, const std::string& message) {
+        if (error) { *error = message; }
+        return false;
+    }
+}
+
+Tablebase::Tablebase() : positions_{0}, maxPlies_{0}, mapping_{nullptr}, mappedBytes_{0}, tables_{nullptr, nullptr} {}
+
+/**
+ * @brief Unmaps the file (see release())
+ */
+Tablebase::~Tablebase() {
+    release();
+}
+
+/**
+ * @brief Unmaps the file or frees the generated tables
+ */
+void Tablebase::release() {
+    if (mapping_) { ::munmap(mapping_, mappedBytes_); }
+    mapping_ = nullptr;
+    mappedBytes_ = 0;
+    std::vector<uint8_t>().swap(owned_);
+    tables_[STRONG_TO_MOVE] = nullptr;
+    tables_[WEAK_TO_MOVE] = nullptr;
+    kinds_.clear();
+    positions_ = 0;
+    maxPlies_ = 0;
+}
+
+/**
+ * @brief Checks a material name such as "KBNK" and sets up kinds_ and positions_ for it
+ * @return False (with an explanation in `error`) if this generator cannot solve the material set
+ */
+bool Tablebase::setMaterial(const std::string& material, std::string* error) {
+    if (material.size() < 3 || material.front() != 'K' || material.back() != 'K') {
+        return fail(error, "material \"" + material + "\" must be K, the strong side's pieces, then K");
+    }
+    std::vector<int> kinds;
+    for (size_t i = 1; i + 1 < material.size(); i++) {
+        const char* letter = std::strchr(PIECE_LETTERS, material[i]);
+        int kind = letter ? int(letter - PIECE_LETTERS) : NO_PIECE_KIND;
+        if (kind != QUEEN_KIND && kind != ROOK_KIND && kind != BISHOP_KIND && kind != KNIGHT_KIND) {
+            return fail(error, "material \"" + material + "\": the strong side may only add Q, R, B and N");
+        }
+        kinds.push_back(kind);
+    }
+    if (int(kinds.size()) > MAX_EXTRA_PIECES) { return fail(error, "material \"" + material + "\" has too many pieces"); }
+
+    // Taking a piece must leave a dead draw (a lone minor piece at most), so the table never needs another one
+    if (kinds.size() == 2) {
+        for (int kind : kinds) {
+            if (kind != BISHOP_KIND && kind != KNIGHT_KIND) {
+                return fail(error, "material \"" + material + "\": with two pieces, both must be Bishops or Knights");
+            }
+        }
+    }
+
+    // Strongest piece first, so "KNBK" and "KBNK" are the same table
+    std::sort(kinds.begin(), kinds.end(), [](const int& a, const int& b) { return a > b; });
+    kinds_ = kinds;
+    positions_ = KING_PAIRS;
+    for (size_t i = 0; i < kinds_.size(); i++) { positions_ *= Bitboards::SQUARE_COUNT; }
+    return true;
+}
+
+/**
+ * @brief Gets the material set's name, eg. "KBNK" (empty before generate() or open())
+ */
+std::string Tablebase::material() const {
+    if (positions_ == 0) { return ""; }
+    std::string name = "K";
+    for (int kind : kinds_) { name += PIECE_LETTERS[kind]; }
+    return name + "K";
+}
+
+/**
+ * @brief Gets the index of the canonical copy of a placement, or SIZE_MAX if the Kings are adjacent or share a square
+ * @param squares The strong King, the weak King, then the pieces in kinds_ order
+ */
+size_t Tablebase::canonicalIndex(const int* squares) const {
+    const Symmetry& sym = symmetry();
+    size_t best = NO_INDEX;
+    for (int t = 0; t < SYMMETRIES; t++) {
+        int pair = sym.kingPair[sym.image[t][squares[0]]][sym.image[t][squares[1]]];
+        if (pair < 0) { continue; }
+
+        // Placements with both Kings on the diagonal have two canonical images; the smaller index wins
+        size_t index = size_t(pair);
+        for (size_t p = 0; p < kinds_.size(); p++) { index = index * Bitboards::SQUARE_COUNT + sym.image[t][squares[2 + p]]; }
+        best = std::min(best, index);
+    }
+    return best;
+}
+
+/**
+ * @brief Recovers the squares of an index (the inverse of canonicalIndex() on canonical placements)
+ */
+void Tablebase::squaresOf(const size_t& index, int* squares) const {
+    size_t rest = index;
+    for (size_t p = kinds_.size(); p-- > 0; ) {
+        squares[2 + p] = int(rest % Bitboards::SQUARE_COUNT);
+        rest /= Bitboards::SQUARE_COUNT;
+    }
+    squares[0] = symmetry().pairSquares[rest][0];
+    squares[1] = symmetry().pairSquares[rest][1];
+}
+
+/**
+ * @brief Gets the squares attacked by the strong side with the given occupancy, skipping piece `skip` (-1 for none)
+ */
+Bitboard Tablebase::strongAttacks(const int* squares, const Bitboard& occupied, const int& skip) const {
+    Bitboard attacks = Attacks::king(squares[0]);
+    for (size_t p = 0; p < kinds_.size(); p++) {
+        if (int(p) == skip) { continue; }
+        int sq = squares[2 + p];
+        switch (kinds_[p]) {
+            case QUEEN_KIND: attacks |= Attacks::queen(sq, occupied); break;
+            case ROOK_KIND: attacks |= Attacks::rook(sq, occupied); break;
+            case BISHOP_KIND: attacks |= Attacks::bishop(sq, occupied); break;
+            default: attacks |= Attacks::knight(sq); break;
+        }
+    }
+    return attacks;
+}
+
+/**
+ * @brief Solves a material set by retrograde analysis
+ * @param material "K", then the strong side's other pieces (Q, R, B or N), then "K": eg. "KQK", "KRK" or "KBNK".
+ *        One piece, or two minor pieces, so that taking any of them leaves a dead draw.
+ * @param threads The number of worker threads. Values below 1 are treated as 1.
+ * @param error If not null, receives a description of the problem when the material set is not supported
+ * @return False if the material set is not supported
+ */
+bool Tablebase::generate(const std::string& material, const int& threads, std::string* error) {
+    release();
+    if (!setMaterial(material, error)) { return false; }
+
+    const int workers = std::max(1, threads);
+    const int pieceCount = 2 + int(kinds_.size());
+    const size_t count = positions_;
+    std::unique_ptr<std::atomic<uint8_t>[]> table[2] = {
+        std::unique_ptr<std::atomic<uint8_t>[]>(new std::atomic<uint8_t>[count]),
+        std::unique_ptr<std::atomic<uint8_t>[]>(new std::atomic<uint8_t>[count])
+    };
+    // Weak-to-move positions: distinct successors not yet known to be lost for the weak side, or DRAWN
+    std::unique_ptr<std::atomic<uint8_t>[]> escapes(new std::atomic<uint8_t>[count]);
+    std::vector<std::vector<uint32_t>> found(workers);
+    const std::memory_order RELAXED = std::memory_order_relaxed;
+
+    // Adds a canonical index to a small set, for counting each distinct neighbour once
+    auto addDistinct = [](size_t* set, int& size, const size_t& index) {
+        for (int i = 0; i < size; i++) {
+            if (set[i] == index) { return; }
+        }
+        set[size++] = index;
+    };
+
+    // Pass 1: mark illegal and non-canonical entries, count the weak side's escapes and collect the checkmates
+    std::atomic<size_t> next{0};
+    runWorkers(workers, [&](const int& thread) {
+        int squares[2 + MAX_EXTRA_PIECES];
+        int moved[2 + MAX_EXTRA_PIECES];
+        for (size_t begin; (begin = next.fetch_add(CHUNK, RELAXED)) < count; ) {
+            for (size_t i = begin; i < std::min(begin + CHUNK, count); i++) {
+                squaresOf(i, squares);
+                Bitboard occupied = 0;
+                for (int p = 0; p < pieceCount; p++) { occupied |= Bitboards::squareBit(squares[p]); }
+                if (Bitboards::popCount(occupied) != pieceCount || canonicalIndex(squares) != i) {
+                    table[STRONG_TO_MOVE][i].store(ENTRY_ILLEGAL, RELAXED);
+                    table[WEAK_TO_MOVE][i].store(ENTRY_ILLEGAL, RELAXED);
+                    escapes[i].store(0, RELAXED);
+                    continue;
+                }
+
+                // With the strong side to move, the weak King may not be in check
+                Bitboard weakKing = Bitboards::squareBit(squares[1]);
+                bool inCheck = (strongAttacks(squares, occupied, -1) & weakKing) != 0;
+                table[STRONG_TO_MOVE][i].store(inCheck ? ENTRY_ILLEGAL : ENTRY_DRAW, RELAXED);
+                table[WEAK_TO_MOVE][i].store(ENTRY_DRAW, RELAXED);
+
+                // The weak King's legal moves, looking through itself for the sliders' rays
+                size_t successors[8];
+                int successorCount = 0;
+                bool drawn = false;
+                Bitboard targets = Attacks::king(squares[1]) & ~Attacks::king(squares[0]);
+                while (targets && !drawn) {
+                    int target = Bitboards::popLowest(targets);
+                    int captured = -1;
+                    for (int p = 2; p < pieceCount; p++) {
+                        if (squares[p] == target) { captured = p - 2; }
+                    }
+                    if (strongAttacks(squares, occupied ^ weakKing, captured) & Bitboards::squareBit(target)) { continue; }
+                    if (captured >= 0) {
+                        drawn = true;   // Taking a piece leaves a dead draw
+                        break;
+                    }
+                    std::copy(squares, squares + pieceCount, moved);
+                    moved[1] = target;
+                    addDistinct(successors, successorCount, canonicalIndex(moved));
+                }
+
+                if (!drawn && successorCount == 0 && inCheck) {
+                    table[WEAK_TO_MOVE][i].store(1, RELAXED);   // Checkmated: mate in 0 plies
+                    found[thread].push_back(uint32_t(i));
+                }
+                escapes[i].store((drawn || successorCount == 0) ? DRAWN : uint8_t(successorCount), RELAXED);
+            }
+        }
+    });
+
+    // Pass 2: walk back one ply at a time from the positions lost in `plies` plies (weak to move, plies even)
+    // or won in `plies` plies (strong to move, plies odd)
+    std::vector<uint32_t> frontier;
+    for (int plies = 0; ; plies++) {
+        frontier.clear();
+        for (std::vector<uint32_t>& list : found) {
+            frontier.insert(frontier.end(), list.begin(), list.end());
+            list.clear();
+        }
+        if (frontier.empty()) { break; }
+        maxPlies_ = plies;
+
+        const bool weakLost = (plies % 2 == 0);
+        const uint8_t entry = uint8_t(plies + 2);   // One more ply to mate, + 1
+        next.store(0, RELAXED);
+        runWorkers(workers, [&](const int& thread) {
+            int squares[2 + MAX_EXTRA_PIECES];
+            int moved[2 + MAX_EXTRA_PIECES];
+            for (size_t begin; (begin = next.fetch_add(CHUNK, RELAXED)) < frontier.size(); ) {
+                for (size_t f = begin; f < std::min(begin + CHUNK, frontier.size()); f++) {
+                    squaresOf(frontier[f], squares);
+                    Bitboard occupied = 0;
+                    for (int p = 0; p < pieceCount; p++) { occupied |= Bitboards::squareBit(squares[p]); }
+                    std::copy(squares, squares + pieceCount, moved);
+
+                    if (weakLost) {
+                        // Every strong move into this position wins: un-move each strong piece (moves never capture)
+                        for (int p = 0; p < pieceCount; p++) {
+                            if (p == 1) { continue; }
+                            Bitboard origins = 0;
+                            if (p == 0) {
+                                origins = Attacks::king(squares[0]) & ~Attacks::king(squares[1]);
+                            } else {
+                                switch (kinds_[p - 2]) {
+                                    case QUEEN_KIND: origins = Attacks::queen(squares[p], occupied); break;
+                                    case ROOK_KIND: origins = Attacks::rook(squares[p], occupied); break;
+                                    case BISHOP_KIND: origins = Attacks::bishop(squares[p], occupied); break;
+                                    default: origins = Attacks::knight(squares[p]); break;
+                                }
+                            }
+                            for (origins &= ~occupied; origins; ) {
+                                moved[p] = Bitboards::popLowest(origins);
+                                size_t j = canonicalIndex(moved);
+                                uint8_t unknown = ENTRY_DRAW;
+                                if (table[STRONG_TO_MOVE][j].compare_exchange_strong(unknown, entry, RELAXED)) {
+                                    found[thread].push_back(uint32_t(j));
+                                }
+                            }
+                            moved[p] = squares[p];
+                        }
+                    } else {
+                        // Un-move the weak King: the predecessor loses once all of its distinct successors do
+                        size_t predecessors[8];
+                        int predecessorCount = 0;
+                        Bitboard origins = Attacks::king(squares[1]) & ~Attacks::king(squares[0]) & ~occupied;
+                        while (origins) {
+                            moved[1] = Bitboards::popLowest(origins);
+                            addDistinct(predecessors, predecessorCount, canonicalIndex(moved));
+                        }
+                        for (int k = 0; k < predecessorCount; k++) {
+                            size_t m = predecessors[k];
+                            uint8_t left = escapes[m].load(RELAXED);
+                            while (left != DRAWN && left > 0 && !escapes[m].compare_exchange_weak(left, uint8_t(left - 1), RELAXED)) {}
+                            if (left == 1) {
+                                table[WEAK_TO_MOVE][m].store(entry, RELAXED);
+                                found[thread].push_back(uint32_t(m));
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    owned_.resize(2 * count);
+    for (int side = 0; side < 2; side++) {
+        for (size_t i = 0; i < count; i++) { owned_[side * count + i] = table[side][i].load(RELAXED); }
+    }
+    tables_[STRONG_TO_MOVE] = owned_.data();
+    tables_[WEAK_TO_MOVE] = owned_.data() + count;
+    return true;
+}
+
+/**
+ * @brief Writes the tables to a file that open() can map
+ * @return False if there is nothing to save or the file could not be written
+ */
+bool Tablebase::save(const std::string& path, std::string* error) const {
+    if (positions_ == 0) { return fail(error, "no table to save"); }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.version = VERSION;
+    for (int p = 0; p < 4; p++) { header.kinds[p] = uint8_t(p < int(kinds_.size()) ? kinds_[p] : NO_PIECE_KIND); }
+    header.maxPlies = uint32_t(maxPlies_);
+    header.positions = positions_;
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) { return fail(error, "cannot create " + path + ": " + std::strerror(errno)); }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(tables_[STRONG_TO_MOVE], 1, positions_, file) == positions_ &&
+              std::fwrite(tables_[WEAK_TO_MOVE], 1, positions_, file) == positions_;
+    ok = (std::fclose(file) == 0) && ok;
+    return ok || fail(error, "cannot write " + path);
+}
+
+/**
+ * @brief Maps a file written by save()
+ * @return False if the file cannot be mapped or is not a complete table of this format
+ */
+bool Tablebase::open(const std::string& path, std::string* error) {
+    release();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return fail(error, "cannot open " + path + ": " + std::strerror(errno)); }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return fail(error, path + " is too short to be a tablebase");
+    }
+    size_t bytes = size_t(info.st_size);
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);   // The mapping keeps the file open
+    if (mapping == MAP_FAILED) { return fail(error, "cannot map " + path + ": " + std::strerror(errno)); }
+
+    const FileHeader* header = static_cast<const FileHeader*>(mapping);
+    std::string name = "K";
+    for (int p = 0; p < 4 && header->kinds[p] < PIECE_KIND_COUNT; p++) { name += PIECE_LETTERS[header->kinds[p]]; }
+    name += "K";
+
+    std::string problem;
+    if (std::memcmp(header->magic, MAGIC, sizeof(header->magic)) != 0) {
+        problem = path + " is not a tablebase";
+    } else if (header->byteOrderMark != BYTE_ORDER_MARK || header->version != VERSION) {
+        problem = path + " has an unsupported version or byte order";
+    } else if (!setMaterial(name, &problem)) {
+        problem = path + ": " + problem;
+    } else if (header->positions != positions_ || bytes < sizeof(FileHeader) + 2 * positions_) {
+        problem = path + " is truncated or does not match its material";
+    }
+    if (!problem.empty()) {
+        ::munmap(mapping, bytes);
+        release();
+        return fail(error, problem);
+    }
+
+    mapping_ = mapping;
+    mappedBytes_ = bytes;
+    maxPlies_ = int(header->maxPlies);
+    tables_[STRONG_TO_MOVE] = static_cast<const uint8_t*>(mapping) + sizeof(FileHeader);
+    tables_[WEAK_TO_MOVE] = tables_[STRONG_TO_MOVE] + positions_;
+    return true;
+}
+
+/**
+ * @brief Looks up a position
+ * @param result Receives the outcome and distance to mate for the side to move
+ * @return False if the board's material is not this table's (either side may hold the pieces), or if the
+ *         position has castling rights
+ * @note Distances ignore the fifty-move rule.
+ */
+bool Tablebase::probe(const ChessBoard& board, Probe& result) const {
+    if (positions_ == 0 || board.getCastlingRights() != 0) { return false; }
+
+    for (int strong = 0; strong < SIDE_COUNT; strong++) {
+        int weak = strong ^ 1;
+        if (board.sidePieces(weak) != board.pieces(weak, KING_KIND)) { continue; }
+        if (Bitboards::popCount(board.sidePieces(strong)) != 1 + int(kinds_.size())) { continue; }
+
+        // Take each piece of the material from the board, in kinds_ order
+        int squares[2 + MAX_EXTRA_PIECES];
+        squares[0] = board.kingSquare(strong);
+        squares[1] = board.kingSquare(weak);
+        Bitboard remaining[PIECE_KIND_COUNT];
+        for (int kind = 0; kind < PIECE_KIND_COUNT; kind++) { remaining[kind] = board.pieces(strong, kind); }
+        bool matches = true;
+        for (size_t p = 0; p < kinds_.size() && matches; p++) {
+            matches = remaining[kinds_[p]] != 0;
+            if (matches) { squares[2 + p] = Bitboards::popLowest(remaining[kinds_[p]]); }
+        }
+        if (!matches) { continue; }
+
+        int toMove = (board.sideToMove() == strong) ? STRONG_TO_MOVE : WEAK_TO_MOVE;
+        uint8_t value = tables_[toMove][canonicalIndex(squares)];
+        if (value == ENTRY_ILLEGAL) { return false; }
+        if (value == ENTRY_DRAW) {
+            result.outcome = DRAW;
+            result.plies = 0;
+        } else {
+            result.outcome = (toMove == STRONG_TO_MOVE) ? WIN : LOSS;
+            result.plies = value - 1;
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,145 @@
+/**
+ * @class Tablebase
+ * @brief Distance-to-mate table for one pawnless endgame where a bare King defends (KQK, KRK, KBNK, ...)
+ *
+ * generate() solves every position of the material set by retrograde analysis: it starts from the checkmates and
+ * walks the move graph backwards one ply at a time, so each position gets the exact number of plies to mate with
+ * best play by both sides. The bare King can only ever draw, by stalemate or by taking a piece, so the table only
+ * distinguishes mates in n plies from draws.
+ *
+ * Without pawns all eight symmetries of the board (the rotations and reflections of Transform) preserve the game,
+ * so only one position of each symmetry class is stored. The two Kings are indexed together into one of 462
+ * canonical placements (strong King in the a1-d1-d4 triangle, no touching Kings); each other piece adds a factor of
+ * 64. KBNK fits in 2 x 462 x 64 x 64 bytes, just under 4 MB.
+ *
+ * Tables can be saved to a file and opened again by mapping it into memory, so they load instantly and several
+ * processes share one copy. probe() looks a ChessBoard up with a fixed amount of work: it reads the material from
+ * the bitboards, then canonicalizes and indexes the piece squares.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../ChessBoard.hpp"
+
+class Tablebase {
+    public:
+        static constexpr int MAX_EXTRA_PIECES = 2;       // Pieces besides the two Kings
+        static constexpr int KING_PAIRS = 462;           // Canonical placements of the two Kings
+
+        // Entries: plies to mate + 1, or one of these
+        static constexpr uint8_t ENTRY_DRAW = 0;
+        static constexpr uint8_t ENTRY_ILLEGAL = 255;    // Not a reachable position, or not the canonical copy of one
+
+        // Indexes of the two tables: which side is to move
+        static constexpr int STRONG_TO_MOVE = 0;
+        static constexpr int WEAK_TO_MOVE = 1;
+
+        // Outcomes for the side to move
+        static constexpr int LOSS = -1;
+        static constexpr int DRAW = 0;
+        static constexpr int WIN = 1;
+
+        /**
+         * @brief The result of probing a position
+         */
+        struct Probe {
+            int outcome;   // WIN, DRAW or LOSS for the side to move
+            int plies;     // Plies to mate with best play by both sides (0 when drawn, or when already mated)
+        };
+
+    private:
+        std::vector<int> kinds_;          // Kinds of the strong side's pieces besides its King, in index order
+        size_t positions_;                // Entries per table: KING_PAIRS x 64^kinds_.size()
+        int maxPlies_;
+        std::vector<uint8_t> owned_;      // Both tables, when generated in this process
+        void* mapping_;                   // The mapped file, when opened
+        size_t mappedBytes_;
+        const uint8_t* tables_[2];        // [STRONG_TO_MOVE] and [WEAK_TO_MOVE]
+
+        /**
+         * @brief Checks a material name such as "KBNK" and sets up kinds_ and positions_ for it
+         * @return False (with an explanation in `error`) if this generator cannot solve the material set
+         */
+        bool setMaterial(const std::string& material, std::string* error);
+
+        /**
+         * @brief Gets the index of the canonical copy of a placement, or SIZE_MAX if the Kings are adjacent or share a square
+         * @param squares The strong King, the weak King, then the pieces in kinds_ order
+         */
+        size_t canonicalIndex(const int* squares) const;
+
+        /**
+         * @brief Recovers the squares of an index (the inverse of canonicalIndex() on canonical placements)
+         */
+        void squaresOf(const size_t& index, int* squares) const;
+
+        /**
+         * @brief Gets the squares attacked by the strong side with the given occupancy, skipping piece `skip` (-1 for none)
+         */
+        Bitboard strongAttacks(const int* squares, const Bitboard& occupied, const int& skip) const;
+
+        /**
+         * @brief Unmaps the file or frees the generated tables
+         */
+        void release();
+
+    public:
+        Tablebase();
+
+        /**
+         * @brief Unmaps the file (see release())
+         */
+        ~Tablebase();
+
+        Tablebase(const Tablebase&) = delete;
+        Tablebase& operator=(const Tablebase&) = delete;
+
+        /**
+         * @brief Solves a material set by retrograde analysis
+         * @param material "K", then the strong side's other pieces (Q, R, B or N), then "K": eg. "KQK", "KRK" or "KBNK".
+         *        One piece, or two minor pieces, so that taking any of them leaves a dead draw.
+         * @param threads The number of worker threads. Values below 1 are treated as 1.
+         * @param error If not null, receives a description of the problem when the material set is not supported
+         * @return False if the material set is not supported
+         */
+        bool generate(const std::string& material, const int& threads, std::string* error = nullptr);
+
+        /**
+         * @brief Writes the tables to a file that open() can map
+         * @return False if there is nothing to save or the file could not be written
+         */
+        bool save(const std::string& path, std::string* error = nullptr) const;
+
+        /**
+         * @brief Maps a file written by save()
+         * @return False if the file cannot be mapped or is not a complete table of this format
+         */
+        bool open(const std::string& path, std::string* error = nullptr);
+
+        /**
+         * @brief Looks up a position
+         * @param result Receives the outcome and distance to mate for the side to move
+         * @return False if the board's material is not this table's (either side may hold the pieces), or if the
+         *         position has castling rights
+         * @note Distances ignore the fifty-move rule.
+         */
+        bool probe(const ChessBoard& board, Probe& result) const;
+
+        /**
+         * @brief Gets the material set's name, eg. "KBNK" (empty before generate() or open())
+         */
+        std::string material() const;
+
+        size_t positions() const { return positions_; }
+        int maxPlies() const { return maxPlies_; }
+
+        /**
+         * @brief Gets a raw entry (plies to mate + 1, ENTRY_DRAW or ENTRY_ILLEGAL)
+         * @pre index < positions()
+         */
+        uint8_t entry(const int& sideToMove, const size_t& index) const { return tables_[sideToMove][index]; }
+};
@@ -0,0 +1,210 @@
+#include "TranspositionTable.hpp"
+
+namespace {
+    const size_t BYTES_PER_MEGABYTE = size_t(1) << 20;
+
+    // Relaxed ordering is enough everywhere: torn slots are caught by the XOR check, and stats are only sampled
+    const std::memory_order RELAXED = std::memory_order_relaxed;
+
+    /**
+     * @brief Gets the largest power of two that is at most n (n >= 1)
+     */
+    size_t floorPowerOfTwo(const size_t& n) {
+        size_t power = 1;
+        while (power <= n / 2) { power *= 2; }
+        return power;
+    }
+}
+
+/**
+ * @brief Constructs a table of (at most) the given size
+ * @param megabytes The table size in MiB. It is rounded down to a power-of-two number of buckets, minimum one bucket.
+ */
+TranspositionTable::TranspositionTable(const size_t& megabytes)
+    : bucketCount_{0}, generation_{0}, stats_{new StatStripe[STAT_STRIPES]} {
+    resize(megabytes);
+}
+
+/**
+ * @brief Reallocates the table at a new size. All entries and stats are lost.
+ * @pre No other thread is using the table
+ */
+void TranspositionTable::resize(const size_t& megabytes) {
+    size_t requested = (megabytes * BYTES_PER_MEGABYTE) / sizeof(Bucket);
+    size_t count = floorPowerOfTwo(requested ? requested : 1);
+    if (count != bucketCount_) {
+        buckets_.reset();  // Free the old table before allocating the new one
+        buckets_.reset(new Bucket[count]);
+        bucketCount_ = count;
+    }
+    clear();
+}
+
+/**
+ * @brief Empties every slot and resets the generation and stats
+ * @pre No other thread is using the table
+ */
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount_; i++) {
+        for (int s = 0; s < SLOTS_PER_BUCKET; s++) {
+            buckets_[i].slots[s].check.store(0, RELAXED);
+            buckets_[i].slots[s].data.store(0, RELAXED);
+        }
+    }
+    generation_ = 0;
+    resetStats();
+}
+
+/**
+ * @brief Gets the calling thread's stat stripe
+ */
+TranspositionTable::StatStripe& TranspositionTable::stripe() const {
+    static std::atomic<int> nextStripe{0};
+    thread_local int index = nextStripe.fetch_add(1, RELAXED) % STAT_STRIPES;
+    return stats_[index];
+}
+
+uint64_t TranspositionTable::pack(const Move& move, const int& score, const int& eval, const int& depth, const int& bound, const int& generation) {
+    return uint64_t(move.raw()) |
+           (uint64_t(uint16_t(int16_t(score))) << 16) |
+           (uint64_t(uint16_t(int16_t(eval))) << 32) |
+           (uint64_t(uint8_t(int8_t(depth))) << 48) |
+           (uint64_t(bound & 3) << 56) |
+           (uint64_t(generation & 63) << 58);
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(const uint64_t& data) {
+    Entry entry;
+    entry.move = Move::fromRaw(uint16_t(data & 0xFFFF));
+    entry.score = int(int16_t((data >> 16) & 0xFFFF));
+    entry.eval = int(int16_t((data >> 32) & 0xFFFF));
+    entry.depth = depthOf(data);
+    entry.bound = int((data >> 56) & 3);
+    return entry;
+}
+
+/**
+ * @brief Looks up a position
+ * @param key The position's Zobrist key
+ * @param entry Receives the stored result on a hit
+ * @return True on a hit. False on a miss, or if the slot was torn by a concurrent write.
+ */
+bool TranspositionTable::probe(const uint64_t& key, Entry& entry) const {
+    StatStripe& counters = stripe();
+    counters.probes.fetch_add(1, RELAXED);
+
+    const Bucket& bucket = bucketFor(key);
+    for (int s = 0; s < SLOTS_PER_BUCKET; s++) {
+        uint64_t data = bucket.slots[s].data.load(RELAXED);
+        uint64_t check = bucket.slots[s].check.load(RELAXED);
+        if ((check ^ data) != key) { continue; }
+
+        entry = unpack(data);
+        if (entry.bound == BOUND_NONE) { continue; }  // An empty slot that happens to verify against key 0
+
+        counters.hits.fetch_add(1, RELAXED);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Records a search result
+ * @param key The position's Zobrist key
+ * @param move The best move found, or the null move to keep the one already stored for this position
+ * @param score The score, already adjusted by the caller for mate distance if needed. Must fit in 16 bits.
+ * @param eval The static evaluation of the position. Must fit in 16 bits.
+ * @param depth The remaining depth the score was searched to, in [-128, 127]
+ * @param bound One of the BOUND_* constants
+ */
+void TranspositionTable::store(const uint64_t& key, const Move& move, const int& score, const int& eval, const int& depth, const int& bound) {
+    stripe().stores.fetch_add(1, RELAXED);
+
+    Bucket& bucket = bucketFor(key);
+    auto write = [&key](Slot& slot, const uint64_t& data) {
+        slot.check.store(key ^ data, RELAXED);
+        slot.data.store(data, RELAXED);
+    };
+
+    // The same position already has a slot: refresh it, keeping its move if we have none to offer
+    for (int s = 0; s < SLOTS_PER_BUCKET; s++) {
+        Slot& slot = bucket.slots[s];
+        uint64_t old = slot.data.load(RELAXED);
+        if ((slot.check.load(RELAXED) ^ old) != key) { continue; }
+
+        Move kept = move.isNull() ? unpack(old).move : move;
+        write(slot, pack(kept, score, eval, depth, bound, generation_));
+        return;
+    }
+
+    // Otherwise pick the weakest depth-preferred slot: empty first, then older generations, then shallower results
+    int victim = 0;
+    int victimWorth = 0;
+    for (int s = 0; s < DEPTH_PREFERRED_SLOTS; s++) {
+        uint64_t data = bucket.slots[s].data.load(RELAXED);
+        int age = (generation_ - generationOf(data)) & 63;
+        int worth = (data == 0) ? -1024 : depthOf(data) - 8 * age;
+        if (s == 0 || worth < victimWorth) {
+            victim = s;
+            victimWorth = worth;
+        }
+    }
+
+    Slot& preferred = bucket.slots[victim];
+    uint64_t displaced = preferred.data.load(RELAXED);
+    uint64_t displacedCheck = preferred.check.load(RELAXED);
+    uint64_t data = pack(move, score, eval, depth, bound, generation_);
+
+    bool stale = displaced == 0 || generationOf(displaced) != generation_;
+    if (stale || depth >= depthOf(displaced)) {
+        // The deeper slot goes to the new result, and what it held drops into the always-replace slot
+        write(preferred, data);
+        if (displaced != 0) {
+            Slot& always = bucket.slots[SLOTS_PER_BUCKET - 1];
+            always.check.store(displacedCheck, RELAXED);
+            always.data.store(displaced, RELAXED);
+        }
+        return;
+    }
+
+    write(bucket.slots[SLOTS_PER_BUCKET - 1], data);
+}
+
+/**
+ * @brief Estimates how full the table is, in permille, from the first 1000 slots (UCI "hashfull")
+ */
+int TranspositionTable::hashfull() const {
+    int used = 0;
+    int sampled = 0;
+    for (size_t i = 0; i < bucketCount_ && sampled < 1000; i++) {
+        for (int s = 0; s < SLOTS_PER_BUCKET && sampled < 1000; s++, sampled++) {
+            uint64_t data = buckets_[i].slots[s].data.load(RELAXED);
+            if (data != 0 && generationOf(data) == generation_) { used++; }
+        }
+    }
+    return sampled ? used * 1000 / sampled : 0;
+}
+
+/**
+ * @brief Sums the usage counters of all threads. Safe to call while other threads use the table.
+ */
+TranspositionTable::Stats TranspositionTable::stats() const {
+    Stats total = { 0, 0, 0 };
+    for (int i = 0; i < STAT_STRIPES; i++) {
+        total.probes += stats_[i].probes.load(RELAXED);
+        total.hits += stats_[i].hits.load(RELAXED);
+        total.stores += stats_[i].stores.load(RELAXED);
+    }
+    return total;
+}
+
+/**
+ * @brief Zeroes the usage counters
+ */
+void TranspositionTable::resetStats() {
+    for (int i = 0; i < STAT_STRIPES; i++) {
+        stats_[i].probes.store(0, RELAXED);
+        stats_[i].hits.store(0, RELAXED);
+        stats_[i].stores.store(0, RELAXED);
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @class TranspositionTable
+ * @brief A fixed-size cache of search results keyed by position hash, shared by any number of threads without locks
+ *
+ * The table is a power-of-two array of 64-byte buckets (one cache line each). A bucket holds four slots:
+ * the first three are depth-preferred (a shallow result never evicts a deeper one from the current search),
+ * and the last is always-replace, so fresh results always find a home.
+ *
+ * Each slot is two 64-bit words written independently: (key ^ data) and data. A reader recomputes
+ * key = word0 ^ word1, so a slot torn by two threads writing at once simply fails verification and
+ * reads as a miss instead of handing back another position's data.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Move.hpp"
+
+class TranspositionTable {
+    public:
+        // How the stored score relates to the true score of the position
+        static constexpr int BOUND_NONE = 0;
+        static constexpr int BOUND_UPPER = 1;   // Score is at most this (failed low)
+        static constexpr int BOUND_LOWER = 2;   // Score is at least this (failed high)
+        static constexpr int BOUND_EXACT = 3;
+
+        static constexpr int SLOTS_PER_BUCKET = 4;
+        static constexpr int DEPTH_PREFERRED_SLOTS = 3;
+
+        /**
+         * @brief A decoded slot, as returned by probe()
+         */
+        struct Entry {
+            Move move;
+            int score;
+            int eval;
+            int depth;
+            int bound;
+        };
+
+        /**
+         * @brief A sample of the table's usage counters
+         */
+        struct Stats {
+            uint64_t probes;
+            uint64_t hits;
+            uint64_t stores;
+
+            /**
+             * @brief Gets hits / probes, or 0 if there have been no probes
+             */
+            double hitRate() const { return probes ? double(hits) / double(probes) : 0.0; }
+        };
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> check;   // key ^ data
+            std::atomic<uint64_t> data;    // move:16 | score:16 | eval:16 | depth:8 | bound:2 | generation:6
+        };
+
+        struct alignas(64) Bucket {
+            Slot slots[SLOTS_PER_BUCKET];
+        };
+
+        // Usage counters are striped across cache lines so threads do not fight over one line on every probe
+        static constexpr int STAT_STRIPES = 64;
+        struct alignas(64) StatStripe {
+            std::atomic<uint64_t> probes;
+            std::atomic<uint64_t> hits;
+            std::atomic<uint64_t> stores;
+        };
+
+        std::unique_ptr<Bucket[]> buckets_;
+        size_t bucketCount_;       // Always a power of two
+        uint8_t generation_;       // Bumped by newSearch(), wraps at 64
+        std::unique_ptr<StatStripe[]> stats_;
+
+        /**
+         * @brief Gets the bucket a key maps to
+         */
+        Bucket& bucketFor(const uint64_t& key) const { return buckets_[key & (bucketCount_ - 1)]; }
+
+        /**
+         * @brief Gets the calling thread's stat stripe
+         */
+        StatStripe& stripe() const;
+
+        static uint64_t pack(const Move& move, const int& score, const int& eval, const int& depth, const int& bound, const int& generation);
+        static Entry unpack(const uint64_t& data);
+        static int depthOf(const uint64_t& data) { return int(int8_t((data >> 48) & 0xFF)); }
+        static int generationOf(const uint64_t& data) { return int(data >> 58); }
+
+    public:
+        /**
+         * @brief Constructs a table of (at most) the given size
+         * @param megabytes The table size in MiB. It is rounded down to a power-of-two number of buckets, minimum one bucket.
+         */
+        explicit TranspositionTable(const size_t& megabytes = 16);
+
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        /**
+         * @brief Reallocates the table at a new size. All entries and stats are lost.
+         * @pre No other thread is using the table
+         */
+        void resize(const size_t& megabytes);
+
+        /**
+         * @brief Empties every slot and resets the generation and stats
+         * @pre No other thread is using the table
+         */
+        void clear();
+
+        /**
+         * @brief Starts a new search generation, so entries from earlier searches become the first to be replaced
+         */
+        void newSearch() { generation_ = uint8_t((generation_ + 1) & 63); }
+
+        /**
+         * @brief Looks up a position
+         * @param key The position's Zobrist key
+         * @param entry Receives the stored result on a hit
+         * @return True on a hit. False on a miss, or if the slot was torn by a concurrent write.
+         */
+        bool probe(const uint64_t& key, Entry& entry) const;
+
+        /**
+         * @brief Records a search result
+         * @param key The position's Zobrist key
+         * @param move The best move found, or the null move to keep the one already stored for this position
+         * @param score The score, already adjusted by the caller for mate distance if needed. Must fit in 16 bits.
+         * @param eval The static evaluation of the position. Must fit in 16 bits.
+         * @param depth The remaining depth the score was searched to, in [-128, 127]
+         * @param bound One of the BOUND_* constants
+         */
+        void store(const uint64_t& key, const Move& move, const int& score, const int& eval, const int& depth, const int& bound);
+
+        /**
+         * @brief Hints the CPU to start loading the bucket for a key
+         */
+        void prefetch(const uint64_t& key) const { __builtin_prefetch(&bucketFor(key)); }
+
+        /**
+         * @brief Gets the size of the table in bytes
+         */
+        size_t sizeInBytes() const { return bucketCount_ * sizeof(Bucket); }
+
+        /**
+         * @brief Estimates how full the table is, in permille, from the first 1000 slots (UCI "hashfull")
+         */
+        int hashfull() const;
+
+        /**
+         * @brief Sums the usage counters of all threads. Safe to call while other threads use the table.
+         */
+        Stats stats() const;
+
+        /**
+         * @brief Zeroes the usage counters
+         */
+        void resetStats();
+};
@@ -0,0 +1,60 @@
+/**
+ * @file Types.hpp
+ * @brief Compact tags for sides, piece colors, piece kinds and (side, kind) piece codes used by the engine tables
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/** The two players. PLAYER_ONE is the side whose pieces start on row 0 and whose pawns move up the board. */
+enum Side {
+    PLAYER_ONE = 0,
+    PLAYER_TWO = 1,
+    SIDE_COUNT = 2
+};
+
+/**
+ * The color string of a ChessPiece as a tag, so pieces compare colors without comparing strings. The two usual colors
+ * get their own tags; every other color shares OTHER_COLOR, and pieces with that tag still compare their strings.
+ */
+enum ColorTag {
+    WHITE_COLOR = 0,
+    BLACK_COLOR,
+    OTHER_COLOR
+};
+
+/** The six piece types, in the order the engine indexes its tables */
+enum PieceKind {
+    PAWN_KIND = 0,
+    KNIGHT_KIND,
+    BISHOP_KIND,
+    ROOK_KIND,
+    QUEEN_KIND,
+    KING_KIND,
+    PIECE_KIND_COUNT,
+    NO_PIECE_KIND = PIECE_KIND_COUNT
+};
+
+namespace PieceCodes {
+    // A piece code packs a side and a kind into one byte: side * PIECE_KIND_COUNT + kind
+    const int CODE_COUNT = SIDE_COUNT * PIECE_KIND_COUNT;
+    const uint8_t NO_PIECE = CODE_COUNT;
+
+    /**
+     * @brief Packs a side and a piece kind into a piece code
+     */
+    inline uint8_t make(const int& side, const int& kind) { return uint8_t(side * PIECE_KIND_COUNT + kind); }
+
+    /**
+     * @brief Gets the side of a piece code
+     * @pre code is not NO_PIECE
+     */
+    inline int sideOf(const uint8_t& code) { return code >= PIECE_KIND_COUNT; }
+
+    /**
+     * @brief Gets the piece kind of a piece code
+     * @pre code is not NO_PIECE
+     */
+    inline int kindOf(const uint8_t& code) { return code % PIECE_KIND_COUNT; }
+}
@@ -0,0 +1,235 @@
+#include "UciDriver.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    const char* const STARTPOS_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    /**
+     * @brief Formats a score as UCI does: "cp <centipawns>", or "mate <moves>" (negative when being mated)
+     */
+    std::string scoreText(const int& score) {
+        if (score > Search::MATE_BOUND) { return "mate " + std::to_string((Search::MATE_SCORE - score + 1) / 2); }
+        if (score < -Search::MATE_BOUND) { return "mate -" + std::to_string((Search::MATE_SCORE + score) / 2); }
+        return "cp " + std::to_string(score);
+    }
+}
+
+/**
+ * @brief Constructs a driver for the standard starting position, with a DEFAULT_HASH_MB table and one thread
+ */
+UciDriver::UciDriver(std::ostream& out) : out_{out}, table_{DEFAULT_HASH_MB}, search_{table_, 1}, searching_{false} {
+    board_.fromFEN(STARTPOS_FEN);
+    search_.onIteration([this](const SearchResult& iteration) {
+        uint64_t nodes = search_.nodes();
+        int64_t elapsed = std::max<int64_t>(iteration.elapsedMs, 1);
+        std::string line = "info depth " + std::to_string(iteration.depth) + " score " + scoreText(iteration.score) +
+                           " nodes " + std::to_string(nodes) + " nps " + std::to_string(nodes * 1000 / uint64_t(elapsed)) +
+                           " time " + std::to_string(iteration.elapsedMs) + " hashfull " + std::to_string(table_.hashfull()) + " pv";
+        for (const Move& move : iteration.pv) { line += " " + move.toString(); }
+        send(line);
+    });
+}
+
+/**
+ * @brief Stops and joins the running search
+ */
+UciDriver::~UciDriver() {
+    stop();
+    waitForSearch();
+}
+
+void UciDriver::send(const std::string& line) {
+    std::lock_guard<std::mutex> guard(outputLock_);
+    out_ << line << std::endl;
+}
+
+/**
+ * @brief Handles one command line
+ * @return False after "quit"
+ */
+bool UciDriver::command(const std::string& line) {
+    std::istringstream args(line);
+    std::string token;
+    if (!(args >> token)) { return true; }
+
+    if (token == "uci") {
+        send("id name p5-235");
+        send("id author KZenny");
+        send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max " + std::to_string(MAX_HASH_MB));
+        send("option name Threads type spin default 1 min 1 max " + std::to_string(LazySmp::MAX_THREADS));
+        send("uciok");
+    } else if (token == "isready") {
+        send("readyok");
+    } else if (token == "ucinewgame") {
+        stop();
+        waitForSearch();
+        table_.clear();
+        board_.fromFEN(STARTPOS_FEN);
+    } else if (token == "setoption") {
+        setOption(args);
+    } else if (token == "position") {
+        position(args);
+    } else if (token == "go") {
+        go(args);
+    } else if (token == "stop") {
+        stop();
+    } else if (token == "ponderhit" || token == "debug" || token == "register") {
+        // Pondering, debug output and registration are not supported; nothing to do
+    } else if (token == "quit") {
+        stop();
+        waitForSearch();
+        return false;
+    } else {
+        send("info string unknown command: " + line);
+    }
+    return true;
+}
+
+/**
+ * @brief Handles command lines until "quit" or the end of the input
+ */
+void UciDriver::loop(std::istream& in) {
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!command(line)) { return; }
+    }
+    stop();
+    waitForSearch();
+}
+
+/**
+ * @brief Sets board_ from "startpos" or "fen <record>", then plays the listed moves
+ * @note An illegal move is reported with "info string", and the position is left after the moves before it (the
+ *       base position if it was the first), as other UCI engines do. A bad record is reported and keeps the
+ *       previous position, since there is no new one to fall back to.
+ */
+void UciDriver::position(std::istringstream& args) {
+    std::string token;
+    std::string fen;
+    args >> token;
+    if (token == "startpos") {
+        fen = STARTPOS_FEN;
+        args >> token;
+    } else if (token == "fen") {
+        while (args >> token && token != "moves") { fen += (fen.empty() ? "" : " ") + token; }
+    } else {
+        send("info string position needs startpos or fen");
+        return;
+    }
+
+    ChessBoard board;
+    std::string error;
+    if (!board.fromFEN(fen, &error)) {
+        send("info string " + error);
+        return;
+    }
+    if (token == "moves") {
+        while (args >> token) {
+            MoveList moves;
+            board.generateLegalMoves(moves);
+            auto match = std::find_if(moves.begin(), moves.end(), [&token](const Move& move) { return move.toString() == token; });
+            if (match == moves.end()) {
+                send("info string illegal move " + token);
+                break;
+            }
+            board.makeMove(*match);
+        }
+    }
+    board_ = board;
+}
+
+/**
+ * @brief Starts a search of board_ on the search thread
+ */
+void UciDriver::go(std::istringstream& args) {
+    stop();
+    waitForSearch();
+
+    SearchLimits limits;
+    int64_t clock[SIDE_COUNT] = { 0, 0 };
+    int64_t increment[SIDE_COUNT] = { 0, 0 };
+    int movesToGo = 0;
+    bool infinite = false;
+    std::string token;
+    while (args >> token) {
+        if (token == "infinite") { infinite = true; continue; }
+        if (token == "ponder") { continue; }
+
+        long long value = 0;
+        if (!(args >> value)) { break; }
+        if (token == "depth") { limits.depth = int(std::max(value, 1LL)); }
+        else if (token == "nodes") { limits.nodes = uint64_t(std::max(value, 1LL)); }
+        else if (token == "movetime") { limits.movetimeMs = std::max(value, 1LL); }
+        else if (token == "wtime") { clock[PLAYER_TWO] = value; }
+        else if (token == "btime") { clock[PLAYER_ONE] = value; }
+        else if (token == "winc") { increment[PLAYER_TWO] = value; }
+        else if (token == "binc") { increment[PLAYER_ONE] = value; }
+        else if (token == "movestogo") { movesToGo = int(value); }
+    }
+
+    // A clock only limits the search when no explicit movetime was given
+    int side = board_.sideToMove();
+    if (!infinite && limits.movetimeMs == 0 && clock[side] > 0) {
+        limits.movetimeMs = timeForMove(clock[side], increment[side], movesToGo);
+    }
+
+    searching_.store(true);
+    ChessBoard root(board_);
+    searchThread_ = std::thread([this, root, limits]() {
+        SearchResult result = search_.run(root, limits);
+        send("bestmove " + result.bestMove.toString());
+        searching_.store(false);
+    });
+}
+
+/**
+ * @brief Handles "setoption name <name> value <value>" for Hash and Threads
+ */
+void UciDriver::setOption(std::istringstream& args) {
+    std::string token;
+    std::string name;
+    std::string value;
+    args >> token;
+    while (args >> token && token != "value") { name += (name.empty() ? "" : " ") + token; }
+    args >> value;
+
+    stop();
+    waitForSearch();
+    if (name == "Hash") {
+        table_.resize(size_t(std::clamp(std::atol(value.c_str()), 1L, long(MAX_HASH_MB))));
+    } else if (name == "Threads") {
+        search_.setThreads(std::atoi(value.c_str()));
+    } else {
+        send("info string unknown option " + name);
+    }
+}
+
+/**
+ * @brief Asks the running search, if any, to stop. Does not wait for it.
+ * @note LazySmp::run() clears the stop signal as it starts, so a stop sent right after "go" waits the moment it
+ *       takes the search to start before raising it.
+ */
+void UciDriver::stop() {
+    if (!searching_.load()) { return; }
+    while (searching_.load() && !search_.isRunning()) { std::this_thread::yield(); }
+    search_.stop();
+}
+
+/**
+ * @brief Waits for the running search, if any, to send its bestmove
+ */
+void UciDriver::waitForSearch() {
+    if (searchThread_.joinable()) { searchThread_.join(); }
+}
+
+/**
+ * @brief Gets the time to spend on a move under a clock
+ */
+int64_t UciDriver::timeForMove(const int64_t& remainingMs, const int64_t& incrementMs, const int& movesToGo) {
+    int64_t moves = movesToGo > 0 ? movesToGo : DEFAULT_MOVES_TO_GO;
+    int64_t budget = remainingMs / moves + incrementMs * 3 / 4;
+    int64_t available = remainingMs - MOVE_OVERHEAD_MS;
+    if (available > 0) { budget = std::min(budget, available); }
+    return std::max<int64_t>(budget, 1);
+}
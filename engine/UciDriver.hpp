@@ -0,0 +1,117 @@
+/**
+ * @class UciDriver
+ * @brief Runs the engine as a UCI (Universal Chess Interface) process: commands in on one stream, replies out on another
+ *
+ * Supported commands:
+ *     uci, isready, ucinewgame, quit
+ *     setoption name Hash value <MiB> / setoption name Threads value <n>
+ *     position startpos|fen <record> [moves <move> ...]
+ *     go [depth <plies>] [nodes <n>] [movetime <ms>] [wtime <ms>] [btime <ms>] [winc <ms>] [binc <ms>]
+ *        [movestogo <n>] [infinite]
+ *     stop
+ *
+ * The caller's thread reads and answers the commands; every search runs on a thread of its own, which prints an
+ * "info" line per completed iteration and "bestmove" at the end. So "isready" and "stop" are answered straight away
+ * while a search is running. Commands that need the search's resources (changing Hash or Threads, ucinewgame, a new
+ * go) first wait for the running search to finish.
+ *
+ * UCI's White is PLAYER_TWO, whose pieces are uppercase in FEN (see ChessBoard::fromFEN()).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../ChessBoard.hpp"
+#include "LazySmp.hpp"
+#include "TranspositionTable.hpp"
+
+class UciDriver {
+    public:
+        static constexpr int DEFAULT_HASH_MB = 16;
+        static constexpr int MAX_HASH_MB = 65536;
+        static constexpr int64_t MOVE_OVERHEAD_MS = 30;   // Kept back from the clock for communication delays
+        static constexpr int DEFAULT_MOVES_TO_GO = 30;    // Moves the remaining clock time is spread over, without movestogo
+
+    private:
+        std::ostream& out_;
+        std::mutex outputLock_;          // One line at a time from the input and search threads
+        TranspositionTable table_;
+        LazySmp search_;
+        ChessBoard board_;               // The position of the last "position" command
+        std::thread searchThread_;
+        std::atomic<bool> searching_;    // From "go" until "bestmove" has been sent
+
+        /**
+         * @brief Writes one line and flushes it
+         */
+        void send(const std::string& line);
+
+        /**
+         * @brief Sets board_ from "startpos" or "fen <record>", then plays the listed moves
+         * @note An illegal move is reported with "info string", and the position is left after the moves before it (the
+         *       base position if it was the first), as other UCI engines do. A bad record is reported and keeps the
+         *       previous position, since there is no new one to fall back to.
+         */
+        void position(std::istringstream& args);
+
+        /**
+         * @brief Starts a search of board_ on the search thread
+         */
+        void go(std::istringstream& args);
+
+        /**
+         * @brief Handles "setoption name <name> value <value>" for Hash and Threads
+         */
+        void setOption(std::istringstream& args);
+
+        /**
+         * @brief Asks the running search, if any, to stop. Does not wait for it.
+         */
+        void stop();
+
+        /**
+         * @brief Waits for the running search, if any, to send its bestmove
+         */
+        void waitForSearch();
+
+    public:
+        /**
+         * @brief Constructs a driver for the standard starting position, with a DEFAULT_HASH_MB table and one thread
+         * @param out The stream replies are written to
+         */
+        explicit UciDriver(std::ostream& out);
+
+        /**
+         * @brief Stops and joins the running search
+         */
+        ~UciDriver();
+
+        UciDriver(const UciDriver&) = delete;
+        UciDriver& operator=(const UciDriver&) = delete;
+
+        /**
+         * @brief Handles one command line
+         * @return False after "quit"
+         */
+        bool command(const std::string& line);
+
+        /**
+         * @brief Handles command lines until "quit" or the end of the input
+         */
+        void loop(std::istream& in);
+
+        /**
+         * @brief Gets the time to spend on a move under a clock
+         * @param remainingMs The mover's clock
+         * @param incrementMs The mover's increment per move
+         * @param movesToGo Moves until the next time control, or 0 if the clock has to last the rest of the game
+         * @return Milliseconds, at least 1 and never more than the clock minus MOVE_OVERHEAD_MS (when that is positive)
+         */
+        static int64_t timeForMove(const int64_t& remainingMs, const int64_t& incrementMs, const int& movesToGo);
+};
@@ -0,0 +1,42 @@
+#include "Zobrist.hpp"
+#include "Prng.hpp"
+
+namespace Zobrist {
+    uint64_t pieceKeys[PieceCodes::CODE_COUNT][Bitboards::SQUARE_COUNT];
+    uint64_t castlingKeys[16];
+    uint64_t enPassantKeys[8];
+    uint64_t playerOneKey;
+}
+
+namespace {
+    const uint64_t SEED = 1070372;
+
+    // Builds the keys before main() runs
+    struct Initializer {
+        Initializer() { Zobrist::init(); }
+    } initializer;
+}
+
+void Zobrist::init() {
+    static bool initialized = false;
+    if (initialized) { return; }
+    initialized = true;
+
+    Prng rng(SEED);
+    for (int code = 0; code < PieceCodes::CODE_COUNT; code++) {
+        for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+            pieceKeys[code][sq] = rng.next();
+        }
+    }
+
+    // Every combination of rights gets its own key, so updating the rights is a single XOR pair
+    for (int rights = 0; rights < 16; rights++) {
+        castlingKeys[rights] = rights ? rng.next() : 0;
+    }
+
+    for (int col = 0; col < 8; col++) {
+        enPassantKeys[col] = rng.next();
+    }
+
+    playerOneKey = rng.next();
+}
@@ -0,0 +1,31 @@
+/**
+ * @namespace Zobrist
+ * @brief Random keys for hashing positions: one per (piece code, square), castling rights set, en passant column and side to move
+ *
+ * A position's key is the XOR of the keys of everything in it, so a move updates it with a handful of XORs.
+ * The keys come from a fixed seed and are identical on every run.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "Bitboard.hpp"
+#include "Types.hpp"
+
+namespace Zobrist {
+    // Lookup tables, filled in by init()
+    extern uint64_t pieceKeys[PieceCodes::CODE_COUNT][Bitboards::SQUARE_COUNT];
+    extern uint64_t castlingKeys[16];
+    extern uint64_t enPassantKeys[8];   // Indexed by the column of the en passant square
+    extern uint64_t playerOneKey;       // Included while it is player one's turn
+
+    /**
+     * @brief Fills in the key tables. Safe to call more than once.
+     * @note This runs automatically during static initialization, so callers never need to call it themselves.
+     */
+    void init();
+
+    inline uint64_t piece(const uint8_t& code, const int& sq) { return pieceKeys[code][sq]; }
+    inline uint64_t castling(const int& rights) { return castlingKeys[rights]; }
+    inline uint64_t enPassant(const int& sq) { return enPassantKeys[Bitboards::colOf(sq)]; }
+}
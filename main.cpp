@@ -1,8 +1,13 @@
+#include <iostream>
 #include "pieces_module.hpp"
 #include "ChessBoard.hpp"
 #include "Transform.hpp"
+#include "engine/UciDriver.hpp"
 
 
 int main() {
+    // Speak UCI on stdin / stdout until "quit"
+    UciDriver driver(std::cout);
+    driver.loop(std::cin);
     return 0;
 }
@@ -1,4 +1,5 @@
 #include "ChessPiece.hpp"
+#include "../engine/Instrumentation.hpp"
 
 /**
  * @brief Default Constructor : All values 
@@ -9,7 +10,9 @@
  * Default type: "NONE"
  * Default size: 0
  */
-ChessPiece::ChessPiece() : color_{"BLACK"}, row_{-1}, column_{-1}, movingUp_{false}, piece_size_{0}, type_{"NULL"}, has_moved_{false} {} 
+ChessPiece::ChessPiece() : color_{"BLACK"}, colorTag_{BLACK_COLOR}, row_{-1}, column_{-1}, movingUp_{false}, piece_size_{0}, type_{"NULL"}, kind_{NO_PIECE_KIND}, has_moved_{false} {
+    INSTRUMENT_COUNT(PIECE_ALLOCATIONS);
+}
 
 /**
 * @brief Parameterized constructor.
@@ -24,7 +27,9 @@ ChessPiece::ChessPiece() : color_{"BLACK"}, row_{-1}, column_{-1}, movingUp_{fal
 *   Default type: "NONE"
 */
 ChessPiece::ChessPiece(const std::string& color, const int& row, const int& col, const bool& movingUp, const int& size, const std::string& type) :
-    color_{"BLACK"}, row_{-1}, column_{-1}, movingUp_{movingUp}, piece_size_{size}, type_{type}, has_moved_{false} {
+    color_{"BLACK"}, colorTag_{BLACK_COLOR}, row_{-1}, column_{-1}, movingUp_{movingUp}, piece_size_{size}, type_{type}, kind_{kindOfType(type)}, has_moved_{false} {
+        INSTRUMENT_COUNT(PIECE_ALLOCATIONS);
+
         // Check for fully alphabetical string & override "BLACK" if valid color
         setColor(color);
         
@@ -34,14 +39,6 @@ ChessPiece::ChessPiece(const std::string& color, const int& row, const int& col,
         if (row_ != -1) { setColumn(col); }
     }
 
-/**
- * @brief Gets the color of the chess piece.
- * @return The string value stored in color_
- */
-std::string ChessPiece::getColor() const { 
-    return color_; 
-}
-
 /**
  * @brief Sets the color of the chess piece.
  * @param color A const string reference, representing the color to set the piece to. 
@@ -59,20 +56,13 @@ bool ChessPiece::setColor(const std::string& color) {
     // If all param characters are successfully converted to uppercase, we use it
     if (uppercase.size() == color.size()) { 
         color_ = std::move(uppercase); 
+        colorTag_ = color_ == "WHITE" ? WHITE_COLOR : color_ == "BLACK" ? BLACK_COLOR : OTHER_COLOR;
         return true;
     }
 
     return false;
 }
 
-/**
- * @brief Gets the row position of the chess piece.
- * @return The integer value stored in row_
- */
-int ChessPiece::getRow() const {
-    return row_;
-}
-
 /**
  * @brief Sets the row position of the chess piece 
  * @param row The new row of the piece as an integer
@@ -88,14 +78,6 @@ void ChessPiece::setRow(const int& row) {
     row_ = row;
 }
 
-/**
- * @brief Gets the column position of the chess piece.
- * @return The integer value stored in column_
- */
-int ChessPiece::getColumn() const {
-    return column_;
-}
-
 /**
  * @brief Sets the column position of the chess piece 
  * @param row A const reference to an integer representing the new column of the piece 
@@ -111,14 +93,6 @@ void ChessPiece::setColumn(const int& column) {
     column_ = column;
 }
 
-/**
- * @brief Gets the value of the flag for if a chess piece is moving up
- * @return The boolean value stored in movingUp_
- */
-bool ChessPiece::isMovingUp() const {
-    return movingUp_;
-}
-
 /**
  * @brief Sets the movingUp flag of the chess piece 
  * @param flag A const reference to an boolean representing whether the piece is now moving up or not
@@ -172,6 +146,18 @@ void ChessPiece::setSize(const int& size)  {
  */
 void ChessPiece::setType(const std::string& type) {
     type_ = type;
+    kind_ = kindOfType(type);
+}
+
+/**
+ * @brief Gets the PieceKind named by a type string ("PAWN", "KNIGHT", ...), or NO_PIECE_KIND
+ */
+uint8_t ChessPiece::kindOfType(const std::string& type) {
+    static const std::string TYPES[PIECE_KIND_COUNT] = { "PAWN", "KNIGHT", "BISHOP", "ROOK", "QUEEN", "KING" };
+    for (int kind = 0; kind < PIECE_KIND_COUNT; kind++) {
+        if (type == TYPES[kind]) { return uint8_t(kind); }
+    }
+    return NO_PIECE_KIND;
 }
 
 /**
@@ -182,9 +168,25 @@ void ChessPiece::flagMoved() {
 }
 
 /**
-* @brief Determines whether a ChessPiece has moved on the board
-* @return The value stored in the `has_moved_` member
+* @brief Sets a ChessPiece's `has_moved_` member to the given value
+* @note Used by ChessBoard to restore the flag when a move is taken back
 */
-bool ChessPiece::hasMoved() const {
-    return has_moved_;
-}
\ No newline at end of file
+void ChessPiece::setMoved(const bool& flag) {
+    has_moved_ = flag;
+}
+
+
+/**
+* @brief Gets every cell of the board the ChessPiece can move to, by asking canMove() about each one
+* @note The chess pieces override this with a single pass (see PieceRules)
+*/
+Bitboard ChessPiece::reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const {
+    INSTRUMENT_COUNT(REACHABLE_QUERIES);
+    Bitboard targets = 0;
+    for (int row = 0; row < BOARD_LENGTH; row++) {
+        for (int col = 0; col < BOARD_LENGTH; col++) {
+            if (canMove(row, col, board)) { targets |= Bitboards::squareBit(Bitboards::square(row, col)); }
+        }
+    }
+    return targets;
+}
@@ -8,14 +8,16 @@
 #pragma once
 #include <iostream>
 #include <cctype>
+#include <string>
 #include <vector>
+#include "../engine/Bitboard.hpp"
+#include "../engine/BoardSize.hpp" // BOARD_LENGTH, the number of rows & columns on the chessboard
+#include "../engine/Types.hpp"
 
 class ChessPiece {
-   protected:
-      static const int BOARD_LENGTH = 8; // A constant value representing the number of rows & columns on the chessboard
-
    private:
       std::string color_;  // An uppercase, alphabetic string representing the color of the chess piece.
+      uint8_t colorTag_;   // The ColorTag matching color_, kept in step by setColor()
 
       /** Consider an 8x8 grid with the following indexing:
          *  7 | * * * * * * * *
@@ -36,8 +38,14 @@ class ChessPiece {
       bool movingUp_;         // A boolean representing whether the piece is moving up the board (in reference to the visual above)
       int piece_size_;        // An integer representing the size of the current chess piece
       std::string type_;      // A string representing the type of the current chess piece
+      uint8_t kind_;          // The PieceKind matching type_ (NO_PIECE_KIND for any other type), for dispatching without a virtual call
       bool has_moved_;
 
+      /**
+       * @brief Gets the PieceKind named by a type string ("PAWN", "KNIGHT", ...), or NO_PIECE_KIND
+       */
+      static uint8_t kindOfType(const std::string& type);
+
    protected:
       /**
        * @brief Setter for the size_ data member
@@ -76,13 +84,18 @@ class ChessPiece {
     */
    ChessPiece(const std::string& color, const int& row = -1, const int& col = -1, const bool& movingUp = false, const int& size = 0, const std::string& type="NONE");
 
+   /**
+    * @brief Destructor. Virtual, since boards own and delete pieces through ChessPiece pointers.
+    */
+   virtual ~ChessPiece() = default;
+
    // =============== Getters and Setters ===============
 
    /**
     * @brief Gets the color of the chess piece.
     * @return The value stored in color_
     */
-   std::string getColor() const;
+   const std::string& getColor() const { return color_; }
 
    /**
     * @brief Sets the color of the chess piece.
@@ -94,11 +107,20 @@ class ChessPiece {
     */
    bool setColor(const std::string& color);
 
+   /**
+    * @brief Determines whether two pieces have the same color
+    * @note Compares the cached color tags, and only falls back to comparing the strings for colors other than
+    *       "WHITE" and "BLACK". PieceRules uses this for every own-piece check.
+    */
+   bool sameColor(const ChessPiece& other) const {
+      return colorTag_ == other.colorTag_ && (colorTag_ != OTHER_COLOR || color_ == other.color_);
+   }
+
    /**
     * @brief Gets the row position of the chess piece.
     * @return The integer value stored in row_
     */
-   int getRow() const;
+   int getRow() const { return row_; }
 
    /**
     * @brief Sets the row position of the chess piece 
@@ -111,7 +133,7 @@ class ChessPiece {
     * @brief Gets the column position of the chess piece.
     * @return The integer value stored in column_
     */
-   int getColumn() const;
+   int getColumn() const { return column_; }
 
    /**
     * @brief Sets the column position of the chess piece 
@@ -124,7 +146,7 @@ class ChessPiece {
     * @brief Gets the value of the flag for if a chess piece is moving up
     * @return The boolean value stored in movingUp_
     */
-   bool isMovingUp() const;
+   bool isMovingUp() const { return movingUp_; }
 
    /**
     * @brief Sets the movingUp flag of the chess piece 
@@ -151,6 +173,13 @@ class ChessPiece {
     * @brief Getter for the type_ data member
     */
    std::string getType() const;
+
+   /**
+    * @brief Gets the piece's kind as a compact tag (see engine/Types.hpp), matching its type string
+    * @return PAWN_KIND ... KING_KIND, or NO_PIECE_KIND for a type that is not one of the six chess pieces
+    * @note PieceRules::canMove() indexes its attack tables with this tag to run the movement rules without a virtual call
+    */
+   int getKind() const { return kind_; }
    
    /**
      * @brief Determines whether the ChessPiece can move to the specified target position on the board.
@@ -161,15 +190,30 @@ class ChessPiece {
      */
    virtual bool canMove(const int& target_row, const int& target_col, const std::vector<std::vector<ChessPiece*>>& board) const = 0;
 
+   /**
+     * @brief Gets every cell of the board the ChessPiece can move to, in one call
+     * @note Each chess piece overrides this with a single pass over the board (see PieceRules). This default asks
+     *       canMove() about every cell, so any other derived class gets the same answer.
+     *
+     * @return A Bitboard with bit (row * 8 + col) set exactly when canMove(row, col, board) is true
+     */
+   virtual Bitboard reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const;
+
    /**
     * @brief Determines whether a ChessPiece has moved on the board
     * @return The value stored in the `has_moved_` member
     */
-   bool hasMoved() const;
+   bool hasMoved() const { return has_moved_; }
 
    /**
     * @brief Sets a ChessPiece's `has_moved_` member to true
     */
    void flagMoved();
 
+   /**
+    * @brief Sets a ChessPiece's `has_moved_` member to the given value
+    * @note Used by ChessBoard to restore the flag when a move is taken back
+    */
+   void setMoved(const bool& flag);
+
 };
\ No newline at end of file
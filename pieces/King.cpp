@@ -1,4 +1,5 @@
 #include "King.hpp"
+#include "PieceRules.hpp"
 
 /**
  * @brief Default Constructor.
@@ -17,13 +18,9 @@ King::King(const std::string& color, const int& row, const int& col, const bool&
     : ChessPiece(color, row, col, movingUp, 4, "KING") {}
 
 bool King::canMove(const int& target_row, const int& target_col, const std::vector<std::vector<ChessPiece*>>& board) const {
-    // Check for bounds and on_board
-    if (getRow() == -1 || getColumn() == -1) { return false; } 
-    if (target_row < 0 || target_row >= BOARD_LENGTH || target_col < 0 || target_col >= BOARD_LENGTH) { return false; } 
+    return PieceRules::king(*this, target_row, target_col, board);
+}
 
-    ChessPiece* target_piece = board[target_row][target_col];
-    if (target_piece && target_piece->getColor() == getColor()) { return false; }
-
-    return (target_row != getRow() || target_col != getColumn() ) &&  
-        (std::abs(target_row - getRow()) <= 1 && std::abs(target_col - getColumn()) <= 1);
-}
\ No newline at end of file
+Bitboard King::reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const {
+    return PieceRules::kingSquares(*this, board);
+}
@@ -1,4 +1,5 @@
 #include "Knight.hpp"
+#include "PieceRules.hpp"
 
 /**
  * @brief Default Constructor.
@@ -17,18 +18,9 @@ Knight::Knight(const std::string& color, const int& row, const int& col, const b
     : ChessPiece(color, row, col, movingUp, 3, "KNIGHT") {}
 
 bool Knight::canMove(const int& target_row, const int& target_col, const std::vector<std::vector<ChessPiece*>>& board) const {
-    // Not on the board
-    if (getRow() == -1 || getColumn() == -1) { return false; }
+    return PieceRules::knight(*this, target_row, target_col, board);
+}
 
-    // Out of bounds target
-    if (target_row < 0 || target_row >= BOARD_LENGTH || target_col < 0 || target_col >= BOARD_LENGTH) { return false; }
-
-    ChessPiece* target_piece = board[target_row][target_col];
-    if (target_piece && target_piece->getColor() == getColor()) { return false; }
-
-    int abs_dx = std::abs(getRow() - target_row);
-    int abs_dy = std::abs(getColumn() - target_col);
-
-    // Check for an L-shape move pattern
-    return (abs_dx == 1 && abs_dy == 2) || (abs_dx == 2 && abs_dy == 1);
-}
\ No newline at end of file
+Bitboard Knight::reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const {
+    return PieceRules::knightSquares(*this, board);
+}
@@ -26,4 +26,9 @@ public:
     Knight(const std::string& color, const int& row = -1, const int& col = -1, const bool& movingUp = false);
 
     bool canMove(const int& target_row, const int& target_col, const std::vector<std::vector<ChessPiece*>>& board) const override;
+
+    /**
+     * @brief Gets every cell canMove() accepts, in a single pass over the board
+     */
+    Bitboard reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const override;
 };
\ No newline at end of file
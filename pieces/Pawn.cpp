@@ -1,4 +1,5 @@
 #include "Pawn.hpp"
+#include "PieceRules.hpp"
 
 /**
  * @brief Default Constructor. All boolean values are default initialized to false.
@@ -44,26 +45,9 @@ bool Pawn::canPromote() const {
 
 // Either two forward, or diagonal to capture piece
 bool Pawn::canMove(const int& target_row, const int& target_col, const std::vector<std::vector<ChessPiece*>>& board) const {
-    // Not on the board 
-    if (getRow() == -1 || getColumn() == -1) { return false; } 
-
-    // Out of bounds target
-    if (target_row < 0 || target_row >= BOARD_LENGTH || target_col < 0 || target_col >= BOARD_LENGTH) { return false; };
-
-    ChessPiece* target_piece = board[target_row][target_col];
-    if (target_piece && target_piece->getColor() == getColor()) { return false; }
-
-
-    int direction = isMovingUp() ? 1 : -1;
-    bool can_move_straight = 
-        (!target_piece && getColumn() == target_col) && // Is moving straight (and there is noe obstructing piece)
-        ((getRow() + direction == target_row) || (canDoubleJump() && getRow() + direction * 2 == target_row)); // Is moving by 1 or 2 rows (depending on the canDoubleJump flag)
-
-
-    bool can_capture_diagonal =
-        (target_piece && std::abs(getColumn() - target_col) == 1) && // Moving along some diagonal
-        (getRow() + direction == target_row); // Moving along a diagonal they are facing
-
+    return PieceRules::pawn(*this, target_row, target_col, board);
+}
 
-    return can_move_straight || can_capture_diagonal;
-}
\ No newline at end of file
+Bitboard Pawn::reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const {
+    return PieceRules::pawnSquares(*this, board);
+}
@@ -43,4 +43,9 @@ class Pawn : public ChessPiece {
         bool canPromote() const;
 
         bool canMove(const int& target_row, const int& target_col, const std::vector<std::vector<ChessPiece*>>& board) const override;
+
+        /**
+         * @brief Gets every cell canMove() accepts, in a single pass over the board
+         */
+        Bitboard reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const override;
 };
\ No newline at end of file
@@ -0,0 +1,281 @@
+/**
+ * @namespace PieceRules
+ * @brief The movement rules of the six chess pieces as inline functions, with a dispatcher driven by the
+ *        piece's kind tag instead of a virtual call
+ *
+ * ChessPiece::canMove() is virtual, so a loop that asks many pieces whether they can reach many squares pays an
+ * indirect call per question and the compiler can see none of the rules. The rules live here instead: each
+ * subclass's canMove() forwards to its rule, and hot loops call canMove() below (or a rule directly when the
+ * piece type is known), which the compiler can inline into the loop. Answers are identical either way.
+ *
+ * The *Squares() rules answer every target at once: they return the Bitboard of all cells canMove() accepts, so a
+ * slider reads each cell on its rays once instead of re-walking a ray per target.
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <vector>
+#include "ChessPiece.hpp"
+#include "../engine/Attacks.hpp"
+#include "../engine/Instrumentation.hpp"
+
+namespace PieceRules {
+    typedef std::vector<std::vector<ChessPiece*>> Board;
+
+    /**
+     * @brief Collects which of the given squares hold a piece on the board
+     * @param mask The squares to read from the board. Only these cells are visited.
+     * @return The subset of `mask` whose cells are non-null
+     */
+    inline Bitboard occupancyWithin(const Bitboard& mask, const Board& board) {
+        Bitboard occupied = 0;
+        for (Bitboard remaining = mask; remaining; ) {
+            int sq = Bitboards::popLowest(remaining);
+            if (board[Bitboards::rowOf(sq)][Bitboards::colOf(sq)]) { occupied |= Bitboards::squareBit(sq); }
+        }
+        return occupied;
+    }
+
+    /**
+     * @brief Checks that no piece stands strictly between two squares, reading those cells from the board only up to
+     *        the first blocker
+     * @return True if the cells in between are all empty (or there are none, as for squares that are not aligned)
+     */
+    inline bool clearBetween(const int& from, const int& to, const Board& board) {
+        for (Bitboard remaining = Attacks::between(from, to); remaining; ) {
+            int sq = Bitboards::popLowest(remaining);
+            if (board[Bitboards::rowOf(sq)][Bitboards::colOf(sq)]) { return false; }
+        }
+        return true;
+    }
+
+    /**
+     * @brief The checks every rule starts with: the piece is on the board, the target is on the board, and the
+     *        target does not hold a piece of the same color
+     * @param target Receives the piece on the target cell (null if it is empty)
+     */
+    inline bool canReach(const ChessPiece& piece, const int& target_row, const int& target_col, const Board& board, ChessPiece*& target) {
+        INSTRUMENT_COUNT(CAN_MOVE_CALLS);
+        if (piece.getRow() == -1 || piece.getColumn() == -1) { return false; }
+        if (target_row < 0 || target_row >= BOARD_LENGTH || target_col < 0 || target_col >= BOARD_LENGTH) { return false; }
+        target = board[target_row][target_col];
+        return !target || !target->sameColor(piece);
+    }
+
+    /**
+     * @brief Pawns move one row forward onto an empty cell (two before they have moved; the skipped cell is not
+     *        checked), or capture one row forward diagonally
+     */
+    inline bool pawn(const ChessPiece& piece, const int& target_row, const int& target_col, const Board& board) {
+        ChessPiece* target = nullptr;
+        if (!canReach(piece, target_row, target_col, board, target)) { return false; }
+
+        int direction = piece.isMovingUp() ? 1 : -1;
+        bool can_move_straight = (!target && piece.getColumn() == target_col) &&
+            ((piece.getRow() + direction == target_row) || (!piece.hasMoved() && piece.getRow() + direction * 2 == target_row));
+        bool can_capture_diagonal = (target && std::abs(piece.getColumn() - target_col) == 1) &&
+            (piece.getRow() + direction == target_row);
+        return can_move_straight || can_capture_diagonal;
+    }
+
+    inline bool knight(const ChessPiece& piece, const int& target_row, const int& target_col, const Board& board) {
+        ChessPiece* target = nullptr;
+        if (!canReach(piece, target_row, target_col, board, target)) { return false; }
+
+        int abs_dx = std::abs(piece.getRow() - target_row);
+        int abs_dy = std::abs(piece.getColumn() - target_col);
+        return (abs_dx == 1 && abs_dy == 2) || (abs_dx == 2 && abs_dy == 1);
+    }
+
+    /**
+     * @brief Sliders: the empty-board attack set says whether the two squares share a line the piece moves along,
+     *        then only the cells strictly between them are read from the board, stopping at the first blocker
+     * @note The legacy board keeps no occupancy bitboard, so the cells in between must still be read one by one.
+     *       A magic lookup on their occupancy would only repeat the test made here, so none is made.
+     */
+    inline bool bishop(const ChessPiece& piece, const int& target_row, const int& target_col, const Board& board) {
+        ChessPiece* target = nullptr;
+        if (!canReach(piece, target_row, target_col, board, target)) { return false; }
+
+        int from = Bitboards::square(piece.getRow(), piece.getColumn());
+        int to = Bitboards::square(target_row, target_col);
+        return (Attacks::emptyBoard(BISHOP_KIND, from) & Bitboards::squareBit(to)) && clearBetween(from, to, board);
+    }
+
+    /**
+     * @note The baseline Rook::canMove() also accepted any target Rook::canCastle() allowed, but only after rejecting
+     *       pieces of the Rook's own color, the only ones canCastle() accepts. That branch was unreachable, so it is
+     *       left out here and in rookSquares(); the answers are the same either way.
+     */
+    inline bool rook(const ChessPiece& piece, const int& target_row, const int& target_col, const Board& board) {
+        ChessPiece* target = nullptr;
+        if (!canReach(piece, target_row, target_col, board, target)) { return false; }
+
+        int from = Bitboards::square(piece.getRow(), piece.getColumn());
+        int to = Bitboards::square(target_row, target_col);
+        return (Attacks::emptyBoard(ROOK_KIND, from) & Bitboards::squareBit(to)) && clearBetween(from, to, board);
+    }
+
+    inline bool queen(const ChessPiece& piece, const int& target_row, const int& target_col, const Board& board) {
+        ChessPiece* target = nullptr;
+        if (!canReach(piece, target_row, target_col, board, target)) { return false; }
+
+        int from = Bitboards::square(piece.getRow(), piece.getColumn());
+        int to = Bitboards::square(target_row, target_col);
+        return (Attacks::emptyBoard(QUEEN_KIND, from) & Bitboards::squareBit(to)) && clearBetween(from, to, board);
+    }
+
+    inline bool king(const ChessPiece& piece, const int& target_row, const int& target_col, const Board& board) {
+        ChessPiece* target = nullptr;
+        if (!canReach(piece, target_row, target_col, board, target)) { return false; }
+
+        return (target_row != piece.getRow() || target_col != piece.getColumn()) &&
+            (std::abs(target_row - piece.getRow()) <= 1 && std::abs(target_col - piece.getColumn()) <= 1);
+    }
+
+    /**
+     * @brief Same answer as piece.canMove(target_row, target_col, board), dispatched on piece.getKind()
+     *
+     * Knights, Bishops, Rooks, Queens and Kings share one path instead of a branch per kind: their empty-board
+     * attack sets are indexed by the kind tag, so a single table lookup answers most targets, and only a target
+     * inside the set is read from the board (its color, then any cells in between). Pawns, whose moves depend on
+     * their direction and on the target cell, keep their own rule.
+     *
+     * @note Pieces whose type is not one of the six chess pieces fall back to the virtual call.
+     */
+    inline bool canMove(const ChessPiece& piece, const int& target_row, const int& target_col, const Board& board) {
+        int kind = piece.getKind();
+        if (kind == PAWN_KIND) { return pawn(piece, target_row, target_col, board); }
+        if (kind == NO_PIECE_KIND) { return piece.canMove(target_row, target_col, board); }
+
+        INSTRUMENT_COUNT(CAN_MOVE_CALLS);
+        if (piece.getRow() == -1 || piece.getColumn() == -1) { return false; }
+        if (target_row < 0 || target_row >= BOARD_LENGTH || target_col < 0 || target_col >= BOARD_LENGTH) { return false; }
+
+        int from = Bitboards::square(piece.getRow(), piece.getColumn());
+        int to = Bitboards::square(target_row, target_col);
+        if (!(Attacks::emptyBoard(kind, from) & Bitboards::squareBit(to))) { return false; }
+
+        ChessPiece* target = board[target_row][target_col];
+        return (!target || !target->sameColor(piece)) && clearBetween(from, to, board);
+    }
+
+    /**
+     * @brief Removes the cells holding a piece of the same color from a set of targets
+     * @param occupied The targets that hold a piece. Only these cells are read from the board.
+     */
+    inline Bitboard withoutOwnPieces(const ChessPiece& piece, const Bitboard& targets, const Bitboard& occupied, const Board& board) {
+        Bitboard result = targets;
+        for (Bitboard remaining = targets & occupied; remaining; ) {
+            int sq = Bitboards::popLowest(remaining);
+            if (board[Bitboards::rowOf(sq)][Bitboards::colOf(sq)]->sameColor(piece)) {
+                result &= ~Bitboards::squareBit(sq);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Every cell pawn() accepts: the empty cell ahead, the cell two ahead if the pawn has not moved and that
+     *        cell is empty (the cell in between is not checked), and the cells diagonally ahead that hold an opposing piece
+     */
+    inline Bitboard pawnSquares(const ChessPiece& piece, const Board& board) {
+        INSTRUMENT_COUNT(REACHABLE_QUERIES);
+        if (piece.getRow() == -1 || piece.getColumn() == -1) { return 0; }
+
+        int direction = piece.isMovingUp() ? 1 : -1;
+        int col = piece.getColumn();
+        Bitboard targets = 0;
+        for (int steps = 1; steps <= 2; steps++) {
+            int row = piece.getRow() + direction * steps;
+            if (row < 0 || row >= BOARD_LENGTH || (steps == 2 && piece.hasMoved())) { break; }
+            if (!board[row][col]) { targets |= Bitboards::squareBit(Bitboards::square(row, col)); }
+        }
+
+        int row = piece.getRow() + direction;
+        if (row < 0 || row >= BOARD_LENGTH) { return targets; }
+        for (int target_col = col - 1; target_col <= col + 1; target_col += 2) {
+            if (target_col < 0 || target_col >= BOARD_LENGTH) { continue; }
+            ChessPiece* target = board[row][target_col];
+            if (target && !target->sameColor(piece)) {
+                targets |= Bitboards::squareBit(Bitboards::square(row, target_col));
+            }
+        }
+        return targets;
+    }
+
+    /**
+     * @brief Every cell knight() accepts
+     */
+    inline Bitboard knightSquares(const ChessPiece& piece, const Board& board) {
+        INSTRUMENT_COUNT(REACHABLE_QUERIES);
+        if (piece.getRow() == -1 || piece.getColumn() == -1) { return 0; }
+
+        Bitboard targets = Attacks::knight(Bitboards::square(piece.getRow(), piece.getColumn()));
+        return withoutOwnPieces(piece, targets, occupancyWithin(targets, board), board);
+    }
+
+    /**
+     * @brief Every cell bishop() accepts. The occupancy of the four rays is read once and the attack table gives the
+     *        whole set, up to and including the first piece on each ray.
+     */
+    inline Bitboard bishopSquares(const ChessPiece& piece, const Board& board) {
+        INSTRUMENT_COUNT(REACHABLE_QUERIES);
+        if (piece.getRow() == -1 || piece.getColumn() == -1) { return 0; }
+
+        int from = Bitboards::square(piece.getRow(), piece.getColumn());
+        Bitboard occupied = occupancyWithin(Attacks::bishop(from, 0), board);
+        return withoutOwnPieces(piece, Attacks::bishop(from, occupied), occupied, board);
+    }
+
+    /**
+     * @brief Every cell rook() accepts
+     */
+    inline Bitboard rookSquares(const ChessPiece& piece, const Board& board) {
+        INSTRUMENT_COUNT(REACHABLE_QUERIES);
+        if (piece.getRow() == -1 || piece.getColumn() == -1) { return 0; }
+
+        int from = Bitboards::square(piece.getRow(), piece.getColumn());
+        Bitboard occupied = occupancyWithin(Attacks::rook(from, 0), board);
+        return withoutOwnPieces(piece, Attacks::rook(from, occupied), occupied, board);
+    }
+
+    /**
+     * @brief Every cell queen() accepts
+     */
+    inline Bitboard queenSquares(const ChessPiece& piece, const Board& board) {
+        INSTRUMENT_COUNT(REACHABLE_QUERIES);
+        if (piece.getRow() == -1 || piece.getColumn() == -1) { return 0; }
+
+        int from = Bitboards::square(piece.getRow(), piece.getColumn());
+        Bitboard occupied = occupancyWithin(Attacks::queen(from, 0), board);
+        return withoutOwnPieces(piece, Attacks::queen(from, occupied), occupied, board);
+    }
+
+    /**
+     * @brief Every cell king() accepts
+     */
+    inline Bitboard kingSquares(const ChessPiece& piece, const Board& board) {
+        INSTRUMENT_COUNT(REACHABLE_QUERIES);
+        if (piece.getRow() == -1 || piece.getColumn() == -1) { return 0; }
+
+        Bitboard targets = Attacks::king(Bitboards::square(piece.getRow(), piece.getColumn()));
+        return withoutOwnPieces(piece, targets, occupancyWithin(targets, board), board);
+    }
+
+    /**
+     * @brief Same answer as piece.reachableSquares(board), dispatched on piece.getKind()
+     */
+    inline Bitboard reachableSquares(const ChessPiece& piece, const Board& board) {
+        switch (piece.getKind()) {
+            case PAWN_KIND:   return pawnSquares(piece, board);
+            case KNIGHT_KIND: return knightSquares(piece, board);
+            case BISHOP_KIND: return bishopSquares(piece, board);
+            case ROOK_KIND:   return rookSquares(piece, board);
+            case QUEEN_KIND:  return queenSquares(piece, board);
+            case KING_KIND:   return kingSquares(piece, board);
+            default:          return piece.reachableSquares(board);
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "Rook.hpp"
+#include "PieceRules.hpp"
 
 /**
  * @brief Default Constructor. By default, Rooks have 3 available castle moves to make
@@ -54,48 +55,9 @@ bool Rook::canCastle(const ChessPiece& target) const {
 }
 
 bool Rook::canMove(const int& target_row, const int& target_col, const std::vector<std::vector<ChessPiece*>>& board) const {
-    // Not on the board 
-    if (getRow() == -1 || getColumn() == -1) { return false; } 
-    // Out of bounds target
-    if (target_row < 0 || target_row >= BOARD_LENGTH || target_col < 0 || target_col >= BOARD_LENGTH) { return false; };
-    
-
-    // Account for castle in ChessBoard move()
-    ChessPiece* target_piece = board[target_row][target_col];
-    if (target_piece) {
-        if (target_piece->getColor() == getColor()) { return false; }
-        if (canCastle(*target_piece)) { return true; } // It can only castle if it is adjacent anyway
-    }
-    
-    // Get the difference between the current position and the target position
-    // -,0,+  -->  represents left, no movement, right
-    int row_difference = target_row - getRow(); 
-    // -,0,+  -->  represents down, no movement, up
-    int col_difference = target_col - getColumn(); 
-
-    // Same cell OR not a horizontal / vertical line
-    bool stays_in_same_position = (row_difference == 0) && (col_difference == 0);
-    bool moves_straight = (row_difference == 0) || (col_difference == 0);
-    if (stays_in_same_position || !moves_straight) { return false; }
-
-    // Find what direction we should step 
-    int increment_row = 0;
-    int increment_col = 0;
-    if (row_difference > 0) { increment_row = 1; }  // Moving right
-    if (row_difference < 0) { increment_row = -1; } // Moving left
-
-    if (col_difference > 0) { increment_col = 1; }  // Moving up
-    if (col_difference < 0) { increment_col = -1; } // Moving down
-    
-    // Iterate from the original space to target space and check if there is any obstructing Chess Piece
-    int temp_row = getRow();
-    int temp_col = getColumn();
-
-    while (temp_row != target_row || temp_col != target_col) {
-        temp_row += increment_row;
-        temp_col += increment_col;
-        if (board[temp_row][temp_col]) { return false; }
-    }
+    return PieceRules::rook(*this, target_row, target_col, board);
+}
 
-    return true;
+Bitboard Rook::reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const {
+    return PieceRules::rookSquares(*this, board);
 }
@@ -55,4 +55,9 @@ class Rook : public ChessPiece {
          * If it is non-adj. 
          */
         bool canMove(const int& target_row, const int& target_col, const std::vector<std::vector<ChessPiece*>>& board) const override;
+
+        /**
+         * @brief Gets every cell canMove() accepts, in a single pass over the board
+         */
+        Bitboard reachableSquares(const std::vector<std::vector<ChessPiece*>>& board) const override;
 };
\ No newline at end of file
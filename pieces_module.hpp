@@ -4,4 +4,5 @@
 #include "pieces/Queen.hpp"
 #include "pieces/King.hpp"
 #include "pieces/Bishop.hpp"
-#include "pieces/Knight.hpp"
\ No newline at end of file
+#include "pieces/Knight.hpp"
+#include "pieces/PieceRules.hpp"
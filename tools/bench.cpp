@@ -0,0 +1,418 @@
+/**
+ * @file bench.cpp
+ * @brief Microbenchmarks of the library's subsystems, with a comparison against a saved baseline
+ *
+ * Covers ChessBoard::findAllQueenPlacements(), QueenSolver<N> and findOneQueenPlacement() at several sizes, groupSimilarBoards(), the Transform
+ * functions at several sizes (each on CharacterBoards and on FlatBoards), BatchEvaluator against ChessBoard::evaluate() at
+ * several batch sizes, each piece's canMove(), and constructing and destroying a ChessBoard.
+ *
+ * Usage: bench_suite [filter ...] [--samples N] [--warmup N] [--min-ms MS] [--save PATH] [--baseline PATH] [--threshold PCT]
+ *     filter           Only run the benchmarks whose name contains one of these strings (default: all)
+ *     --samples N      Timed samples per benchmark (default 15)
+ *     --warmup N       Untimed samples run first, to warm caches and the branch predictors (default 3)
+ *     --min-ms MS      Each sample repeats the operation until it has run for at least MS milliseconds (default 5)
+ *     --save PATH      Also write the results to PATH, to serve as a later baseline
+ *     --baseline PATH  Compare each median with the one saved in PATH
+ *     --threshold PCT  With --baseline, flag medians more than PCT percent slower as regressions (default 10)
+ *
+ * Results are printed one benchmark per line as tab-separated fields, after a '#' header line:
+ *     name  iterations  median_ns  p10_ns  p90_ns  min_ns  max_ns
+ * where iterations is the number of operations per sample and the times are nanoseconds per operation over the
+ * samples. Saved files have the same format. With --baseline, each line gains the baseline median, the ratio and
+ * "ok", "REGRESSION" or "new", and the exit status is 1 if any benchmark regressed.
+ *
+ * Before anything is timed, BatchEvaluator::evaluate() and evaluateScalar() are checked against ChessBoard::evaluate()
+ * on every position the batch benchmarks use; if any score differs, the mismatch count is printed and the exit status is 1.
+ * The batch benchmarks time one whole batch, so positions per second is the batch size over the median.
+ *
+ * In an INSTRUMENT=1 build the instrumentation counters are printed as a JSON comment line at the end.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../ChessBoard.hpp"
+#include "../Transform.hpp"
+#include "../engine/BatchEvaluator.hpp"
+#include "../engine/Instrumentation.hpp"
+#include "../engine/Prng.hpp"
+#include "../engine/QueenSolver.hpp"
+
+namespace {
+    typedef std::vector<std::vector<char>> CharacterBoard;
+
+    // Positions per batch in the BatchEvaluator benchmarks; the largest is also the number of positions drawn
+    const size_t BATCH_SIZES[] = { 1, 8, 64, 1024 };
+    const size_t BATCH_POSITIONS = 1024;
+    const int MAX_GAME_PLIES = 200;
+
+    /**
+     * @brief Keeps the compiler from discarding a result that is never used
+     */
+    template <typename T>
+    void keep(const T& value) { asm volatile("" : : "r"(&value) : "memory"); }
+
+    struct Benchmark {
+        std::string name;
+        std::function<void()> run;   // One operation
+    };
+
+    struct Result {
+        std::string name;
+        uint64_t iterations;
+        double median;
+        double p10;
+        double p90;
+        double min;
+        double max;
+    };
+
+    /**
+     * @brief Gets a percentile of sorted samples, interpolating between the two nearest
+     */
+    double percentile(const std::vector<double>& sorted, const double& fraction) {
+        double position = fraction * double(sorted.size() - 1);
+        size_t below = size_t(position);
+        size_t above = std::min(below + 1, sorted.size() - 1);
+        return sorted[below] + (sorted[above] - sorted[below]) * (position - double(below));
+    }
+
+    double secondsOf(const Benchmark& benchmark, const uint64_t& iterations) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++) { benchmark.run(); }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Picks the iterations per sample (doubling until a sample lasts minSeconds), warms up, then times the samples
+     */
+    Result measure(const Benchmark& benchmark, const int& samples, const int& warmup, const double& minSeconds) {
+        uint64_t iterations = 1;
+        while (secondsOf(benchmark, iterations) < minSeconds && iterations < (uint64_t(1) << 40)) { iterations *= 2; }
+        for (int w = 0; w < warmup; w++) { secondsOf(benchmark, iterations); }
+
+        std::vector<double> perOperation;
+        for (int s = 0; s < samples; s++) {
+            perOperation.push_back(secondsOf(benchmark, iterations) * 1e9 / double(iterations));
+        }
+        std::sort(perOperation.begin(), perOperation.end());
+        return { benchmark.name, iterations, percentile(perOperation, 0.5), percentile(perOperation, 0.1),
+                 percentile(perOperation, 0.9), perOperation.front(), perOperation.back() };
+    }
+
+    std::string format(const Result& result) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%s\t%llu\t%.1f\t%.1f\t%.1f\t%.1f\t%.1f", result.name.c_str(),
+                      (unsigned long long)result.iterations, result.median, result.p10, result.p90, result.min, result.max);
+        return line;
+    }
+
+    /**
+     * @brief Reads the medians of a file written with --save
+     * @return False if the file cannot be read
+     */
+    bool readBaseline(const std::string& path, std::map<std::string, double>& medians) {
+        std::ifstream file(path);
+        if (!file) { return false; }
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') { continue; }
+            std::istringstream fields(line);
+            std::string name;
+            unsigned long long iterations = 0;
+            double median = 0;
+            if (std::getline(fields, name, '\t') && fields >> iterations >> median) { medians[name] = median; }
+        }
+        return true;
+    }
+
+    /**
+     * @brief A square matrix of characters, with a few cells filled in
+     */
+    CharacterBoard patternBoard(const int& n, Prng& random) {
+        CharacterBoard board(n, std::vector<char>(n, '*'));
+        for (int i = 0; i < n; i++) { board[random.next() % n][random.next() % n] = 'Q'; }
+        return board;
+    }
+
+    /**
+     * @brief Boards for groupSimilarBoards: `classes` random boards, each with a few of its symmetric copies
+     */
+    std::vector<CharacterBoard> groupingInput(const int& classes, Prng& random) {
+        std::vector<CharacterBoard> boards;
+        for (int c = 0; c < classes; c++) {
+            CharacterBoard board = patternBoard(8, random);
+            boards.push_back(board);
+            boards.push_back(Transform::rotate(board));
+            boards.push_back(Transform::flipAcrossVertical(board));
+            boards.push_back(Transform::flipAcrossHorizontal(Transform::rotate(board)));
+        }
+        for (size_t i = boards.size(); i > 1; i--) { std::swap(boards[i - 1], boards[random.next() % i]); }
+        return boards;
+    }
+
+    /**
+     * @brief The Transform benchmarks for an N x N FlatBoard
+     */
+    template <int N>
+    void addFlatTransforms(std::vector<Benchmark>& benchmarks, Prng& random) {
+        auto board = std::make_shared<FlatBoard<N>>(FlatBoard<N>::fromCharacterBoard(patternBoard(N, random)));
+        std::string size = std::to_string(N);
+        benchmarks.push_back({ "transform/flat/rotate/" + size, [board] { keep(Transform::rotate(*board)); } });
+        benchmarks.push_back({ "transform/flat/flipAcrossVertical/" + size, [board] { keep(Transform::flipAcrossVertical(*board)); } });
+        benchmarks.push_back({ "transform/flat/flipAcrossHorizontal/" + size, [board] { keep(Transform::flipAcrossHorizontal(*board)); } });
+    }
+
+    /**
+     * @brief A position reached by a fixed sequence of random moves, holding every kind of piece
+     */
+    std::unique_ptr<ChessBoard> middlegame(Prng& random) {
+        std::unique_ptr<ChessBoard> board(new ChessBoard());
+        for (int ply = 0; ply < 24; ply++) {
+            MoveList moves;
+            board->generateLegalMoves(moves);
+            if (moves.empty()) { break; }
+            board->makeMove(moves[int(random.next() % moves.size())]);
+        }
+        return board;
+    }
+
+    /**
+     * @brief Every position of random games from the default position, restarting a game when it ends or grows long
+     */
+    std::vector<ChessBoard> gamePositions(const size_t& count, Prng& random) {
+        std::vector<ChessBoard> positions;
+        ChessBoard board;
+        int ply = 0;
+        while (positions.size() < count) {
+            MoveList moves;
+            board.generateLegalMoves(moves);
+            if (moves.empty() || board.isDraw() || ply == MAX_GAME_PLIES) {
+                board = ChessBoard();
+                ply = 0;
+                continue;
+            }
+            board.makeMove(moves[int(random.next() % moves.size())]);
+            positions.push_back(board);
+            ply++;
+        }
+        return positions;
+    }
+
+    /**
+     * @brief Counts the positions on which BatchEvaluator::evaluate(), evaluateScalar(), ChessBoard::evaluate() and
+     *        ChessBoard::computeEvaluation() do not all agree, at every batch size the benchmarks use
+     */
+    size_t batchMismatches(const std::vector<ChessBoard>& positions) {
+        size_t mismatches = 0;
+        for (size_t size : BATCH_SIZES) {
+            BatchEvaluator batch(size);
+            for (size_t i = 0; i < size; i++) { batch.add(positions[i]); }
+            std::vector<int> scores(size);
+            std::vector<int> scalarScores(size);
+            batch.evaluate(scores.data());
+            batch.evaluateScalar(scalarScores.data());
+            for (size_t i = 0; i < size; i++) {
+                int expected = positions[i].evaluate();
+                mismatches += scores[i] != expected || scalarScores[i] != expected || positions[i].computeEvaluation() != expected;
+            }
+        }
+        return mismatches;
+    }
+
+    std::vector<Benchmark> allBenchmarks(const std::vector<std::vector<ChessPiece*>>& cells, const std::shared_ptr<const std::vector<ChessBoard>>& positions) {
+        std::vector<Benchmark> benchmarks;
+
+        benchmarks.push_back({ "queens/findAllQueenPlacements/8", [] { keep(ChessBoard::findAllQueenPlacements()); } });
+        benchmarks.push_back({ "queens/QueenSolver::findAll/6", [] { keep(QueenSolver<6>::findAll()); } });
+        benchmarks.push_back({ "queens/QueenSolver::findAll/8", [] { keep(QueenSolver<8>::findAll()); } });
+        benchmarks.push_back({ "queens/QueenSolver::findAll/10", [] { keep(QueenSolver<10>::findAll()); } });
+        benchmarks.push_back({ "queens/QueenSolver::findAllFlat/8", [] { keep(QueenSolver<8>::findAllFlat()); } });
+        benchmarks.push_back({ "queens/QueenSolver::findAllFlat/10", [] { keep(QueenSolver<10>::findAllFlat()); } });
+        benchmarks.push_back({ "queens/QueenSolver::count/12", [] { keep(QueenSolver<12>::count()); } });
+        benchmarks.push_back({ "queens/findOneQueenPlacement/1000", [] { keep(ChessBoard::findOneQueenPlacement(1000)); } });
+        benchmarks.push_back({ "queens/findOneQueenPlacement/100000", [] { keep(ChessBoard::findOneQueenPlacement(100000)); } });
+        benchmarks.push_back({ "queens/QueenSolver::count/20", [] {
+            // Stopped after 10 ms: measures the 32-bit masks and the token polling, not a full count
+            uint64_t solutions = 0;
+            keep(QueenSolver<20>::count(CancellationToken::after(std::chrono::milliseconds(10)), solutions));
+        } });
+
+        Prng random(44);
+        auto solutions = std::make_shared<std::vector<CharacterBoard>>(ChessBoard::findAllQueenPlacements());
+        benchmarks.push_back({ "grouping/groupSimilarBoards/queens92", [solutions] { keep(ChessBoard::groupSimilarBoards(*solutions)); } });
+        for (int classes : { 4, 16, 32 }) {
+            auto boards = std::make_shared<std::vector<CharacterBoard>>(groupingInput(classes, random));
+            benchmarks.push_back({ "grouping/groupSimilarBoards/synthetic" + std::to_string(boards->size()),
+                                   [boards] { keep(ChessBoard::groupSimilarBoards(*boards)); } });
+        }
+
+        for (int n : { 8, 32, 128 }) {
+            auto matrix = std::make_shared<CharacterBoard>(patternBoard(n, random));
+            std::string size = std::to_string(n);
+            benchmarks.push_back({ "transform/rotate/" + size, [matrix] { keep(Transform::rotate(*matrix)); } });
+            benchmarks.push_back({ "transform/flipAcrossVertical/" + size, [matrix] { keep(Transform::flipAcrossVertical(*matrix)); } });
+            benchmarks.push_back({ "transform/flipAcrossHorizontal/" + size, [matrix] { keep(Transform::flipAcrossHorizontal(*matrix)); } });
+        }
+
+        // The grouping inputs again, as flat boards (drawn after the others, so their inputs stay the same)
+        auto flatSolutions = std::make_shared<std::vector<ChessBoard::FlatCharacterBoard>>(ChessBoard::findAllFlatQueenPlacements());
+        benchmarks.push_back({ "grouping/groupSimilarBoards/flat/queens92", [flatSolutions] { keep(ChessBoard::groupSimilarBoards(*flatSolutions)); } });
+        for (int classes : { 4, 16, 32, 1024 }) {
+            auto boards = std::make_shared<std::vector<ChessBoard::FlatCharacterBoard>>();
+            for (const CharacterBoard& board : groupingInput(classes, random)) {
+                boards->push_back(ChessBoard::FlatCharacterBoard::fromCharacterBoard(board));
+            }
+            benchmarks.push_back({ "grouping/groupSimilarBoards/flat/synthetic" + std::to_string(boards->size()),
+                                   [boards] { keep(ChessBoard::groupSimilarBoards(*boards)); } });
+        }
+        addFlatTransforms<8>(benchmarks, random);
+        addFlatTransforms<32>(benchmarks, random);
+        addFlatTransforms<128>(benchmarks, random);
+
+        // One whole batch per operation, against the same positions scored one at a time: evaluate() only blends the
+        // running sums a ChessBoard keeps, while computeEvaluation() sums the tables from scratch as the batch does
+        for (size_t size : BATCH_SIZES) {
+            auto batch = std::make_shared<BatchEvaluator>(size);
+            for (size_t i = 0; i < size; i++) { batch->add((*positions)[i]); }
+            auto scores = std::make_shared<std::vector<int>>(size);
+            std::string count = std::to_string(size);
+            benchmarks.push_back({ "eval/BatchEvaluator::evaluate/" + count, [batch, scores] { batch->evaluate(scores->data()); keep(*scores); } });
+            benchmarks.push_back({ "eval/BatchEvaluator::evaluateScalar/" + count, [batch, scores] {
+                batch->evaluateScalar(scores->data());
+                keep(*scores);
+            } });
+            benchmarks.push_back({ "eval/ChessBoard::evaluate/" + count, [positions, size] {
+                int total = 0;
+                for (size_t i = 0; i < size; i++) { total += (*positions)[i].evaluate(); }
+                keep(total);
+            } });
+            benchmarks.push_back({ "eval/ChessBoard::computeEvaluation/" + count, [positions, size] {
+                int total = 0;
+                for (size_t i = 0; i < size; i++) { total += (*positions)[i].computeEvaluation(); }
+                keep(total);
+            } });
+        }
+
+        // Each kind of piece, asked about all 64 cells of the position through the virtual call
+        const char* kindNames[PIECE_KIND_COUNT] = { "Pawn", "Knight", "Bishop", "Rook", "Queen", "King" };
+        for (int kind = 0; kind < PIECE_KIND_COUNT; kind++) {
+            const ChessPiece* piece = nullptr;
+            for (int sq = 0; sq < Bitboards::SQUARE_COUNT && !piece; sq++) {
+                const ChessPiece* cell = cells[Bitboards::rowOf(sq)][Bitboards::colOf(sq)];
+                if (cell && cell->getKind() == kind) { piece = cell; }
+            }
+            if (!piece) { continue; }
+            benchmarks.push_back({ std::string("canMove/") + kindNames[kind] + "/64cells", [piece, &cells] {
+                int reachable = 0;
+                for (int row = 0; row < 8; row++) {
+                    for (int col = 0; col < 8; col++) { reachable += piece->canMove(row, col, cells); }
+                }
+                keep(reachable);
+            } });
+        }
+        benchmarks.push_back({ "board/ChessBoard/constructDestroy", [] { ChessBoard board; keep(board); } });
+        return benchmarks;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> filters;
+    int samples = 15;
+    int warmup = 3;
+    double minMilliseconds = 5;
+    std::string savePath;
+    std::string baselinePath;
+    double threshold = 10;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            samples = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            minMilliseconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+        } else {
+            filters.push_back(argv[i]);
+        }
+    }
+    if (samples < 1) { samples = 1; }
+    if (warmup < 0) { warmup = 0; }
+
+    std::map<std::string, double> baseline;
+    if (!baselinePath.empty() && !readBaseline(baselinePath, baseline)) {
+        std::fprintf(stderr, "cannot read baseline %s\n", baselinePath.c_str());
+        return 1;
+    }
+
+    Prng random(1);
+    std::unique_ptr<ChessBoard> position = middlegame(random);
+    std::vector<std::vector<ChessPiece*>> cells(8, std::vector<ChessPiece*>(8, nullptr));
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) { cells[row][col] = position->getCell(row, col); }
+    }
+
+    Prng gameRandom(38);
+    auto positions = std::make_shared<const std::vector<ChessBoard>>(gamePositions(BATCH_POSITIONS, gameRandom));
+    size_t mismatches = batchMismatches(*positions);
+    if (mismatches > 0) {
+        std::fprintf(stderr, "BatchEvaluator disagrees with ChessBoard::evaluate() on %zu position(s)%s\n", mismatches,
+                     BatchEvaluator::usesAvx2() ? " (AVX2 build)" : "");
+        return 1;
+    }
+
+    std::string header = "# name\titerations\tmedian_ns\tp10_ns\tp90_ns\tmin_ns\tmax_ns";
+    std::printf("%s%s\n", header.c_str(), baselinePath.empty() ? "" : "\tbaseline_ns\tratio\tstatus");
+    std::string saved = header + "\n";
+    int regressions = 0;
+    for (const Benchmark& benchmark : allBenchmarks(cells, positions)) {
+        bool selected = filters.empty();
+        for (const std::string& filter : filters) { selected = selected || benchmark.name.find(filter) != std::string::npos; }
+        if (!selected) { continue; }
+
+        Result result = measure(benchmark, samples, warmup, minMilliseconds / 1000);
+        std::string line = format(result);
+        saved += line + "\n";
+        if (!baselinePath.empty()) {
+            auto previous = baseline.find(result.name);
+            if (previous == baseline.end() || previous->second <= 0) {
+                line += "\t-\t-\tnew";
+            } else {
+                double ratio = result.median / previous->second;
+                bool regressed = ratio > 1 + threshold / 100;
+                regressions += regressed;
+                char comparison[64];
+                std::snprintf(comparison, sizeof(comparison), "\t%.1f\t%.3f\t%s", previous->second, ratio, regressed ? "REGRESSION" : "ok");
+                line += comparison;
+            }
+        }
+        std::printf("%s\n", line.c_str());
+        std::fflush(stdout);
+    }
+
+    if (Instrumentation::ENABLED) { std::printf("# %s\n", Instrumentation::toJson(Instrumentation::snapshot()).c_str()); }
+
+    if (!savePath.empty()) {
+        std::ofstream file(savePath);
+        if (!(file << saved) || !file.flush()) {
+            std::fprintf(stderr, "cannot write %s\n", savePath.c_str());
+            return 1;
+        }
+    }
+    if (!baselinePath.empty()) { std::printf("# %d regression(s) beyond %.1f%%\n", regressions, threshold); }
+    return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/**
+ * @file dispatch.cpp
+ * @brief Compares virtual ChessPiece::canMove() calls with the tag-dispatched PieceRules::canMove()
+ *
+ * Usage: dispatch_bench [queries] [--boards N] [--repeat N]
+ *     queries     Random (piece, target cell) questions to ask (default 1000000)
+ *     --boards N  Positions to draw the pieces from, taken from random games (default 64)
+ *     --repeat N  Timed passes over the queries per path; the fastest pass is reported (default 5)
+ *
+ * Two workloads of the same size are timed:
+ *     random  Each query asks a random piece of a random position about a random cell, so the piece kind changes
+ *             unpredictably from one query to the next
+ *     sweep   Each piece in turn is asked about all 64 cells, like the tight loops over board squares in the solvers
+ * Both paths must give the same answer to every query. Prints nanoseconds per query for each path and workload,
+ * and the speedup.
+ *
+ * Then every piece's reachableSquares() is checked against canMove() on all 64 cells, and one reachableSquares()
+ * call is timed against the 64 canMove() calls it replaces.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "../ChessBoard.hpp"
+#include "../engine/Prng.hpp"
+
+namespace {
+    typedef std::vector<std::vector<ChessPiece*>> Cells;
+
+    struct Query {
+        const ChessPiece* piece;
+        const Cells* cells;
+        int row;
+        int col;
+    };
+
+    /**
+     * @brief Times one pass of `ask` over the queries, returning seconds; `yes` receives the number of true answers
+     */
+    template <typename Ask>
+    double timePass(const std::vector<Query>& queries, Ask ask, size_t& yes) {
+        auto start = std::chrono::steady_clock::now();
+        size_t count = 0;
+        for (const Query& query : queries) { count += ask(query); }
+        yes = count;
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t queryCount = 1000000;
+    int boardCount = 64;
+    int repeat = 5;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--boards") == 0 && i + 1 < argc) {
+            boardCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+        } else {
+            queryCount = size_t(std::atoll(argv[i]));
+        }
+    }
+    if (boardCount < 1) { boardCount = 1; }
+    if (repeat < 1) { repeat = 1; }
+
+    // Positions from random games, each with its grid of cells
+    Prng random(41);
+    std::vector<std::unique_ptr<ChessBoard>> boards;
+    std::vector<Cells> cells(boardCount, Cells(8, std::vector<ChessPiece*>(8, nullptr)));
+    std::vector<std::vector<const ChessPiece*>> pieces(boardCount);
+    for (int b = 0; b < boardCount; b++) {
+        boards.emplace_back(new ChessBoard());
+        int plies = int(random.next() % 80);
+        for (int ply = 0; ply < plies; ply++) {
+            MoveList moves;
+            boards[b]->generateLegalMoves(moves);
+            if (moves.empty()) { break; }
+            boards[b]->makeMove(moves[int(random.next() % moves.size())]);
+        }
+        for (int row = 0; row < 8; row++) {
+            for (int col = 0; col < 8; col++) {
+                cells[b][row][col] = boards[b]->getCell(row, col);
+                if (cells[b][row][col]) { pieces[b].push_back(cells[b][row][col]); }
+            }
+        }
+    }
+
+    std::vector<Query> randomQueries(queryCount);
+    for (Query& query : randomQueries) {
+        int b = int(random.next() % boardCount);
+        query.cells = &cells[b];
+        query.piece = pieces[b][random.next() % pieces[b].size()];
+        query.row = int(random.next() % 8);
+        query.col = int(random.next() % 8);
+    }
+    std::vector<Query> sweepQueries(queryCount);
+    for (size_t i = 0; i < queryCount; i++) {
+        size_t pieceNumber = i / 64;
+        int b = int(pieceNumber % size_t(boardCount));
+        sweepQueries[i].cells = &cells[b];
+        sweepQueries[i].piece = pieces[b][(pieceNumber / size_t(boardCount)) % pieces[b].size()];
+        sweepQueries[i].row = int(i % 64) / 8;
+        sweepQueries[i].col = int(i % 64) % 8;
+    }
+
+    std::printf("%zu queries per workload over %d positions, best of %d passes\n", queryCount, boardCount, repeat);
+    double perQuery = 1e9 / double(queryCount ? queryCount : 1);
+    size_t mismatches = 0;
+    const char* names[2] = { "random", "sweep" };
+    const std::vector<Query>* workloads[2] = { &randomQueries, &sweepQueries };
+    for (int w = 0; w < 2; w++) {
+        const std::vector<Query>& queries = *workloads[w];
+
+        // Both paths must agree on every query
+        for (const Query& query : queries) {
+            mismatches += query.piece->canMove(query.row, query.col, *query.cells) !=
+                          PieceRules::canMove(*query.piece, query.row, query.col, *query.cells);
+        }
+
+        double virtualBest = 0;
+        double dispatchBest = 0;
+        size_t virtualYes = 0;
+        size_t dispatchYes = 0;
+        for (int pass = 0; pass < repeat; pass++) {
+            double seconds = timePass(queries, [](const Query& q) {
+                return q.piece->canMove(q.row, q.col, *q.cells);
+            }, virtualYes);
+            virtualBest = (pass == 0 || seconds < virtualBest) ? seconds : virtualBest;
+
+            seconds = timePass(queries, [](const Query& q) {
+                return PieceRules::canMove(*q.piece, q.row, q.col, *q.cells);
+            }, dispatchYes);
+            dispatchBest = (pass == 0 || seconds < dispatchBest) ? seconds : dispatchBest;
+        }
+        mismatches += virtualYes != dispatchYes;
+
+        std::printf("%-6s virtual canMove: %7.2f ns/query   PieceRules::canMove: %7.2f ns/query  (%.2fx, %zu reachable)\n",
+                    names[w], virtualBest * perQuery, dispatchBest * perQuery,
+                    dispatchBest > 0 ? virtualBest / dispatchBest : 0.0, virtualYes);
+    }
+    // reachableSquares() must set exactly the cells canMove() accepts, through both the virtual call and the dispatcher
+    std::vector<Query> allPieces;
+    for (int b = 0; b < boardCount; b++) {
+        for (const ChessPiece* piece : pieces[b]) { allPieces.push_back({ piece, &cells[b], 0, 0 }); }
+    }
+    for (const Query& query : allPieces) {
+        Bitboard expected = 0;
+        for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+            if (query.piece->canMove(Bitboards::rowOf(sq), Bitboards::colOf(sq), *query.cells)) { expected |= Bitboards::squareBit(sq); }
+        }
+        mismatches += query.piece->reachableSquares(*query.cells) != expected;
+        mismatches += PieceRules::reachableSquares(*query.piece, *query.cells) != expected;
+    }
+
+    // One whole-board query per piece against 64 single-cell queries, over the same number of cells as above
+    size_t rounds = queryCount / (64 * allPieces.size()) + 1;
+    double cellsBest = 0;
+    double squaresBest = 0;
+    size_t cellsYes = 0;
+    size_t squaresYes = 0;
+    for (int pass = 0; pass < repeat; pass++) {
+        auto start = std::chrono::steady_clock::now();
+        size_t count = 0;
+        for (size_t round = 0; round < rounds; round++) {
+            for (const Query& query : allPieces) {
+                for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) {
+                    count += PieceRules::canMove(*query.piece, Bitboards::rowOf(sq), Bitboards::colOf(sq), *query.cells);
+                }
+            }
+        }
+        cellsYes = count;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        cellsBest = (pass == 0 || seconds < cellsBest) ? seconds : cellsBest;
+
+        start = std::chrono::steady_clock::now();
+        count = 0;
+        for (size_t round = 0; round < rounds; round++) {
+            for (const Query& query : allPieces) {
+                count += size_t(Bitboards::popCount(PieceRules::reachableSquares(*query.piece, *query.cells)));
+            }
+        }
+        squaresYes = count;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        squaresBest = (pass == 0 || seconds < squaresBest) ? seconds : squaresBest;
+    }
+    mismatches += cellsYes != squaresYes;
+
+    double perPiece = 1e9 / double(rounds * allPieces.size());
+    std::printf("whole board: 64 canMove calls %8.2f ns/piece   reachableSquares: %7.2f ns/piece  (%.2fx, %zu pieces)\n",
+                cellsBest * perPiece, squaresBest * perPiece, squaresBest > 0 ? cellsBest / squaresBest : 0.0, allPieces.size());
+    std::printf("mismatches: %zu\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
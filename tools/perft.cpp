@@ -0,0 +1,76 @@
+/**
+ * @file perft.cpp
+ * @brief Perft throughput benchmark for the move generation path
+ *
+ * Usage: perft_bench [depth] [--divide] [--threads N] [--hash MB]
+ *     depth        Plies to expand from the default ChessBoard position (default 5)
+ *     --divide     Also print the subtree count below each root move (serial)
+ *     --threads N  Split the first two plies across N worker threads (default 1)
+ *     --hash MB    Memoize subtree counts in a table of MB MiB (default 0, off)
+ *
+ * With --threads or --hash the parallel, hashed perft is used; its counts are identical to the serial run.
+ * Prints the node count, the elapsed wall time and the nodes per second.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../ChessBoard.hpp"
+#include "../engine/ParallelPerft.hpp"
+
+namespace {
+    // Reference counts from the standard starting position (the default board is a mirror image of it)
+    const uint64_t EXPECTED[] = { 1, 20, 400, 8902, 197281, 4865609, 119060324, 3195901860ULL, 84998978956ULL };
+    const int EXPECTED_DEPTHS = sizeof(EXPECTED) / sizeof(EXPECTED[0]);
+}
+
+int main(int argc, char* argv[]) {
+    int depth = 5;
+    bool divide = false;
+    int threads = 1;
+    size_t hashMegabytes = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--divide") == 0) {
+            divide = true;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--hash") == 0 && i + 1 < argc) {
+            hashMegabytes = size_t(std::atol(argv[++i]));
+        } else {
+            depth = std::atoi(argv[i]);
+        }
+    }
+    if (depth < 1) {
+        std::fprintf(stderr, "usage: %s [depth >= 1] [--divide] [--threads N] [--hash MB]\n", argv[0]);
+        return 1;
+    }
+
+    ChessBoard board;
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t nodes = 0;
+    if (divide) {
+        std::vector<std::pair<Move, uint64_t>> counts = board.perftDivide(depth);
+        for (size_t i = 0; i < counts.size(); i++) {
+            std::printf("%s: %llu\n", counts[i].first.toString().c_str(), (unsigned long long)counts[i].second);
+            nodes += counts[i].second;
+        }
+        std::printf("\n");
+    } else if (threads > 1 || hashMegabytes > 0) {
+        nodes = ParallelPerft(threads, hashMegabytes).run(board, depth);
+    } else {
+        nodes = board.perft(depth);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("perft(%d) = %llu nodes\n", depth, (unsigned long long)nodes);
+    std::printf("time      = %.3f s\n", seconds);
+    std::printf("nps       = %.0f\n", seconds > 0 ? double(nodes) / seconds : 0.0);
+
+    if (depth < EXPECTED_DEPTHS && nodes != EXPECTED[depth]) {
+        std::printf("MISMATCH: expected %llu\n", (unsigned long long)EXPECTED[depth]);
+        return 1;
+    }
+    return 0;
+}
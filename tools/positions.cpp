@@ -0,0 +1,148 @@
+/**
+ * @file positions.cpp
+ * @brief Builds a position database and measures writing, scanning and decoding it
+ *
+ * Usage: positions_bench [count] [--threads N] [--file PATH] [--fen FILE]
+ *     count        Positions to collect from random games from the default ChessBoard position (default 1000000)
+ *     --threads N  Threads for the scans (default 1)
+ *     --file PATH  Database file to write and read back (default positions.db)
+ *     --fen FILE   Pack the FEN records of FILE, one per line, instead of playing random games
+ *
+ * Prints the file size per position next to the average FEN length, then the rate of a raw scan (reading every
+ * square of every record in place) and of a decoding scan (setting up a ChessBoard from every record and checking
+ * that it packs back to the same bytes).
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../ChessBoard.hpp"
+#include "../engine/PositionDatabase.hpp"
+#include "../engine/Prng.hpp"
+
+namespace {
+    const int MAX_GAME_PLIES = 200;
+
+    double secondsSince(const std::chrono::steady_clock::time_point& start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Appends positions from random games until `count` are written; returns the total FEN length
+     */
+    size_t writeRandomGames(PositionDatabaseWriter& writer, const size_t& count) {
+        Prng random(2025);
+        ChessBoard start;
+        size_t fenBytes = 0;
+        while (writer.count() < count) {
+            ChessBoard board(start);
+            for (int ply = 0; ply < MAX_GAME_PLIES && writer.count() < count; ply++) {
+                MoveList moves;
+                board.generateLegalMoves(moves);
+                if (moves.size() == 0 || board.isDraw()) { break; }
+                board.makeMove(moves[random.next() % moves.size()]);
+                writer.append(board);
+                fenBytes += board.toFEN().size();
+            }
+        }
+        return fenBytes;
+    }
+
+    /**
+     * @brief Appends the FEN records of a file; returns the total FEN length
+     */
+    size_t writeFenFile(PositionDatabaseWriter& writer, const char* path) {
+        std::ifstream in(path);
+        if (!in) { std::fprintf(stderr, "cannot read %s\n", path); }
+        ChessBoard board;
+        std::string line;
+        std::string error;
+        size_t fenBytes = 0;
+        while (std::getline(in, line)) {
+            if (line.empty()) { continue; }
+            if (!board.fromFEN(line, &error)) {
+                std::fprintf(stderr, "skipped \"%s\": %s\n", line.c_str(), error.c_str());
+                continue;
+            }
+            writer.append(board);
+            fenBytes += line.size();
+        }
+        return fenBytes;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = 1000000;
+    int threads = 1;
+    std::string path = "positions.db";
+    const char* fenPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (std::strcmp(argv[i], "--fen") == 0 && i + 1 < argc) {
+            fenPath = argv[++i];
+        } else {
+            count = size_t(std::atoll(argv[i]));
+        }
+    }
+    if (threads < 1) { threads = 1; }
+
+    std::string error;
+    PositionDatabaseWriter writer;
+    if (!writer.open(path, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    size_t fenBytes = fenPath ? writeFenFile(writer, fenPath) : writeRandomGames(writer, count);
+    size_t written = writer.count();
+    if (!writer.close()) {
+        std::fprintf(stderr, "cannot finish writing %s\n", path.c_str());
+        return 1;
+    }
+    double seconds = secondsSince(start);
+    std::printf("wrote %zu positions to %s in %.3f s (%.1f bytes/position; FEN averages %.1f)\n", written,
+                path.c_str(), seconds, double(sizeof(PackedPosition)), written ? double(fenBytes) / double(written) : 0.0);
+
+    PositionDatabaseReader reader;
+    if (!reader.open(path, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    // Raw scan: every square of every record, read in place
+    std::atomic<uint64_t> pieces{0};
+    start = std::chrono::steady_clock::now();
+    reader.scan(threads, [&pieces](const PackedPosition& record, const size_t&, const int&) {
+        uint64_t found = 0;
+        for (int sq = 0; sq < Bitboards::SQUARE_COUNT; sq++) { found += record.pieceCodeAt(sq) != PieceCodes::NO_PIECE; }
+        pieces.fetch_add(found, std::memory_order_relaxed);
+    });
+    seconds = secondsSince(start);
+    std::printf("raw scan:    %.3f s, %10.0f positions/s (%llu pieces, %d threads)\n", seconds,
+                seconds > 0 ? double(reader.size()) / seconds : 0.0, (unsigned long long)pieces.load(), threads);
+
+    // Decoding scan: one scratch board per thread, and every record must pack back to itself
+    std::vector<std::unique_ptr<ChessBoard>> boards;
+    for (int t = 0; t < threads; t++) { boards.emplace_back(new ChessBoard()); }
+    std::atomic<uint64_t> mismatches{0};
+    start = std::chrono::steady_clock::now();
+    reader.scan(threads, [&boards, &mismatches](const PackedPosition& record, const size_t&, const int& thread) {
+        PackedPosition repacked;
+        if (!record.unpack(*boards[thread]) || !PackedPosition::pack(*boards[thread], repacked) || repacked != record) {
+            mismatches.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    seconds = secondsSince(start);
+    std::printf("decode scan: %.3f s, %10.0f positions/s (%llu mismatches)\n", seconds,
+                seconds > 0 ? double(reader.size()) / seconds : 0.0, (unsigned long long)mismatches.load());
+    return mismatches.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file scheduler.cpp
+ * @brief Runs expensive and latency-sensitive solver jobs side by side on a Scheduler
+ *
+ * Usage: scheduler_bench [short jobs] [--threads N] [--long N] [--boards N] [--deadline MS] [--interval MS]
+ *     short jobs     8-queens solves to submit at HIGH priority (default 100)
+ *     --threads N    Worker threads (default 2)
+ *     --long N       groupSimilarBoards jobs to submit first, at LOW priority (default 8)
+ *     --boards N     Boards per grouping job (default 512)
+ *     --deadline MS  Deadline of each grouping job, counted from its submission (default 50)
+ *     --interval MS  Pause between short job submissions (default 3)
+ *
+ * The same workload runs twice: once with the grouping jobs' deadlines, once without. For each run, prints the
+ * latency percentiles of the short jobs (submission to result) and how many grouping jobs finished, were stopped
+ * by their deadline while running, or were skipped because it had passed before they started.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+#include "../ChessBoard.hpp"
+#include "../Transform.hpp"
+#include "../engine/Prng.hpp"
+#include "../engine/Scheduler.hpp"
+
+namespace {
+    typedef std::vector<std::vector<char>> CharacterBoard;
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Random 8x8 boards with a few queens, each followed by some of its symmetric copies, shuffled
+     */
+    std::vector<CharacterBoard> groupingInput(const int& count, Prng& random) {
+        std::vector<CharacterBoard> boards;
+        while (int(boards.size()) < count) {
+            CharacterBoard board(8, std::vector<char>(8, '*'));
+            for (int i = 0; i < 8; i++) { board[random.next() % 8][random.next() % 8] = 'Q'; }
+            boards.push_back(board);
+            boards.push_back(Transform::rotate(board));
+            boards.push_back(Transform::flipAcrossVertical(board));
+        }
+        boards.resize(count);
+        for (size_t i = boards.size(); i > 1; i--) { std::swap(boards[i - 1], boards[random.next() % i]); }
+        return boards;
+    }
+
+    double percentile(std::vector<double> values, const double& fraction) {
+        if (values.empty()) { return 0; }
+        std::sort(values.begin(), values.end());
+        return values[size_t(fraction * double(values.size() - 1) + 0.5)];
+    }
+
+    void runWorkload(const char* label, const int& threads, const int& shortJobs, const int& longJobs,
+                     const std::vector<CharacterBoard>& boards, const int& deadlineMs, const int& intervalMs) {
+        Scheduler scheduler(threads);
+
+        std::vector<std::future<bool>> groupings;
+        for (int i = 0; i < longJobs; i++) {
+            CancellationToken token = deadlineMs > 0 ? CancellationToken::after(std::chrono::milliseconds(deadlineMs)) : CancellationToken();
+            groupings.push_back(scheduler.submit([&boards](const CancellationToken& token) {
+                std::vector<std::vector<CharacterBoard>> groups;
+                return ChessBoard::groupSimilarBoards(boards, token, groups);
+            }, Scheduler::LOW, token));
+        }
+
+        std::vector<Clock::time_point> submitted;
+        std::vector<std::future<Clock::time_point>> solves;
+        for (int i = 0; i < shortJobs; i++) {
+            submitted.push_back(Clock::now());
+            solves.push_back(scheduler.submit([](const CancellationToken& token) {
+                std::vector<CharacterBoard> solutions;
+                ChessBoard::findAllQueenPlacements(token, solutions);
+                return Clock::now();
+            }, Scheduler::HIGH));
+            std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+        }
+
+        std::vector<double> latencies;
+        for (int i = 0; i < shortJobs; i++) {
+            latencies.push_back(std::chrono::duration<double, std::milli>(solves[i].get() - submitted[i]).count());
+        }
+        int finished = 0;
+        int stopped = 0;
+        int skipped = 0;
+        for (std::future<bool>& grouping : groupings) {
+            try {
+                (grouping.get() ? finished : stopped)++;
+            } catch (const Scheduler::Cancelled&) {
+                skipped++;
+            }
+        }
+
+        std::printf("%-16s 8-queens latency p50 %7.2f ms  p90 %7.2f ms  p99 %7.2f ms  max %7.2f ms | grouping jobs: "
+                    "%d finished, %d stopped, %d skipped\n", label, percentile(latencies, 0.5), percentile(latencies, 0.9),
+                    percentile(latencies, 0.99), percentile(latencies, 1.0), finished, stopped, skipped);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int shortJobs = 100;
+    int threads = 2;
+    int longJobs = 8;
+    int boardCount = 512;
+    int deadlineMs = 50;
+    int intervalMs = 3;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--long") == 0 && i + 1 < argc) {
+            longJobs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--boards") == 0 && i + 1 < argc) {
+            boardCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--deadline") == 0 && i + 1 < argc) {
+            deadlineMs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            intervalMs = std::atoi(argv[++i]);
+        } else {
+            shortJobs = std::atoi(argv[i]);
+        }
+    }
+
+    Prng random(46);
+    std::vector<CharacterBoard> boards = groupingInput(std::max(boardCount, 1), random);
+    std::printf("%d threads, %d grouping jobs of %zu boards, %d 8-queens jobs every %d ms\n",
+                threads, longJobs, boards.size(), shortJobs, intervalMs);
+    runWorkload("with deadlines", threads, shortJobs, longJobs, boards, deadlineMs, intervalMs);
+    runWorkload("no deadlines", threads, shortJobs, longJobs, boards, 0, intervalMs);
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file search.cpp
+ * @brief Time-to-depth benchmark for the (Lazy-SMP) search
+ *
+ * Usage: search_bench [depth] [--threads N] [--hash MB] [--movetime MS]
+ *     depth          Iterations to complete from the default ChessBoard position (default 8)
+ *     --threads N    Search threads, including the main one (default 1)
+ *     --hash MB      Shared transposition table size in MiB (default 64)
+ *     --movetime MS  Also stop after MS milliseconds (default 0, no limit)
+ *
+ * Prints one line per completed iteration (depth, score, nodes, time, nps, effective branching factor, share of
+ * beta cutoffs on the first move, principal variation), then the best move and the node count of each thread.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../ChessBoard.hpp"
+#include "../engine/LazySmp.hpp"
+
+int main(int argc, char* argv[]) {
+    SearchLimits limits;
+    limits.depth = 8;
+    int threads = 1;
+    size_t hashMegabytes = 64;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--hash") == 0 && i + 1 < argc) {
+            hashMegabytes = size_t(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--movetime") == 0 && i + 1 < argc) {
+            limits.movetimeMs = std::atol(argv[++i]);
+        } else {
+            limits.depth = std::atoi(argv[i]);
+        }
+    }
+    if (limits.depth < 1) {
+        std::fprintf(stderr, "usage: %s [depth >= 1] [--threads N] [--hash MB] [--movetime MS]\n", argv[0]);
+        return 1;
+    }
+
+    ChessBoard board;
+    TranspositionTable table(hashMegabytes);
+    LazySmp search(table, threads);
+    search.onIteration([&search](const SearchResult& iteration) {
+        uint64_t nodes = search.nodes();
+        double seconds = double(iteration.elapsedMs) / 1000.0;
+        double firstMove = iteration.cutoffs ? 100.0 * double(iteration.firstMoveCutoffs) / double(iteration.cutoffs) : 0.0;
+        std::printf("depth %2d  score %6d  nodes %12llu  time %8.3f s  nps %10.0f  ebf %5.2f  first %5.1f%%  pv",
+                    iteration.depth, iteration.score, (unsigned long long)nodes, seconds,
+                    seconds > 0 ? double(nodes) / seconds : 0.0, iteration.branchingFactor, firstMove);
+        for (size_t i = 0; i < iteration.pv.size(); i++) { std::printf(" %s", iteration.pv[i].toString().c_str()); }
+        std::printf("\n");
+    });
+
+    SearchResult result = search.run(board, limits);
+    std::printf("bestmove %s  (threads = %d, hashfull = %d/1000)\n", result.bestMove.toString().c_str(),
+                search.threads(), table.hashfull());
+
+    std::vector<uint64_t> counts = search.threadNodes();
+    for (size_t i = 0; i < counts.size(); i++) {
+        std::printf("thread %3zu: %llu nodes\n", i, (unsigned long long)counts[i]);
+    }
+    return 0;
+}
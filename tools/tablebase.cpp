@@ -0,0 +1,149 @@
+/**
+ * @file tablebase.cpp
+ * @brief Generates endgame tablebases, saves them, maps them back and checks them against the move rules
+ *
+ * Usage: tablebase_gen [material ...] [--threads N] [--dir PATH] [--verify N]
+ *     material    Material sets to solve, eg. KQK KRK KBNK (the default)
+ *     --threads N Generation threads (default 1)
+ *     --dir PATH  Directory for the <material>.tb files (default .)
+ *     --verify N  Probe N random positions through ChessBoard and check each result against the results one move
+ *                 later (default 10000)
+ *
+ * For every table, prints the generation time, the number of legal positions, the share of wins and the longest
+ * mate in moves, then the verification result.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../ChessBoard.hpp"
+#include "../engine/Prng.hpp"
+#include "../engine/Tablebase.hpp"
+
+namespace {
+    /**
+     * @brief Sets up a random position of the table's material, with either side holding the pieces
+     */
+    bool randomPosition(Prng& random, const Tablebase& table, ChessBoard& board) {
+        uint8_t codes[Bitboards::SQUARE_COUNT];
+        std::fill(codes, codes + Bitboards::SQUARE_COUNT, PieceCodes::NO_PIECE);
+        int strong = int(random.next() % 2);
+        std::string material = table.material();
+        for (size_t i = 0; i < material.size(); i++) {
+            int sq = int(random.next() % Bitboards::SQUARE_COUNT);
+            if (codes[sq] != PieceCodes::NO_PIECE) { return false; }
+            int side = (i + 1 == material.size()) ? strong ^ 1 : strong;
+            int kind = int(std::strchr("PNBRQK", material[i]) - "PNBRQK");
+            codes[sq] = PieceCodes::make(side, kind);
+        }
+        return board.setPosition(codes, random.next() % 2 == 0, 0, Bitboards::NO_SQUARE, 0, 1);
+    }
+
+    /**
+     * @brief Checks a probe against the probes of every position one legal move later
+     * @return False if the result does not follow from its successors
+     */
+    bool consistent(const Tablebase& table, ChessBoard& board) {
+        Tablebase::Probe result;
+        if (!table.probe(board, result)) { return false; }
+
+        MoveList moves;
+        board.generateLegalMoves(moves);
+        if (moves.empty()) {
+            bool mated = board.isCheck();
+            return mated ? (result.outcome == Tablebase::LOSS && result.plies == 0) : result.outcome == Tablebase::DRAW;
+        }
+
+        // The best successor for the mover: a quickest loss for the opponent, else a draw, else the slowest win
+        int bestOutcome = Tablebase::LOSS;
+        int bestPlies = -1;
+        for (const Move& move : moves) {
+            board.makeMove(move);
+            Tablebase::Probe reply;
+            // Captures leave the table's material, and are always draws
+            if (!table.probe(board, reply)) { reply.outcome = Tablebase::DRAW; reply.plies = 0; }
+            board.unmakeMove();
+
+            int outcome = -reply.outcome;
+            if (outcome > bestOutcome ||
+                (outcome == bestOutcome && outcome == Tablebase::WIN && reply.plies < bestPlies) ||
+                (outcome == bestOutcome && outcome == Tablebase::LOSS && reply.plies > bestPlies)) {
+                bestOutcome = outcome;
+                bestPlies = reply.plies;
+            }
+        }
+        if (bestOutcome != result.outcome) { return false; }
+        return bestOutcome == Tablebase::DRAW || bestPlies + 1 == result.plies;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> materials;
+    int threads = 1;
+    std::string directory = ".";
+    int samples = 10000;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            directory = argv[++i];
+        } else if (std::strcmp(argv[i], "--verify") == 0 && i + 1 < argc) {
+            samples = std::atoi(argv[++i]);
+        } else {
+            materials.push_back(argv[i]);
+        }
+    }
+    if (materials.empty()) { materials = { "KQK", "KRK", "KBNK" }; }
+
+    bool allGood = true;
+    for (const std::string& material : materials) {
+        std::string error;
+        Tablebase generated;
+        auto start = std::chrono::steady_clock::now();
+        if (!generated.generate(material, threads, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::string path = directory + "/" + generated.material() + ".tb";
+        Tablebase table;
+        if (!generated.save(path, &error) || !table.open(path, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+
+        uint64_t legal = 0;
+        uint64_t wins = 0;
+        for (int side = 0; side < 2; side++) {
+            for (size_t i = 0; i < table.positions(); i++) {
+                uint8_t entry = table.entry(side, i);
+                legal += entry != Tablebase::ENTRY_ILLEGAL;
+                wins += entry != Tablebase::ENTRY_ILLEGAL && entry != Tablebase::ENTRY_DRAW;
+            }
+        }
+        std::printf("%-5s generated in %.3f s (%d threads): %llu legal positions, %.1f%% won, longest mate %d moves -> %s\n",
+                    table.material().c_str(), seconds, threads, (unsigned long long)legal,
+                    legal ? 100.0 * double(wins) / double(legal) : 0.0, (table.maxPlies() + 1) / 2, path.c_str());
+
+        // Random positions through ChessBoard: each probe must follow from the probes one move later
+        Prng random(7);
+        ChessBoard board;
+        int checked = 0;
+        int failures = 0;
+        while (checked < samples) {
+            if (!randomPosition(random, table, board)) { continue; }
+            checked++;
+            if (!consistent(table, board)) {
+                failures++;
+                if (failures <= 5) { std::printf("      inconsistent: %s\n", board.toFEN().c_str()); }
+            }
+        }
+        std::printf("      verified %d random positions: %d inconsistent\n", checked, failures);
+        allGood = allGood && failures == 0;
+    }
+    return allGood ? 0 : 1;
+}
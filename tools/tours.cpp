@@ -0,0 +1,131 @@
+/**
+ * @file tours.cpp
+ * @brief Times KnightTour: tours counted per second on small boards, and single tours found on large ones
+ *
+ * Usage: tour_bench [--open RxC] [--closed RxC] [--find N] [--threads N] [--enumerate]
+ *     --open RxC     Counts the open tours of a rows x columns board (at most 64 squares) from every square
+ *     --closed RxC   Counts the closed tours of a board from its first square (each one once per direction)
+ *     --find N       Finds one tour of an N x N board from a corner and from the centre, and checks them
+ *     --threads N    Worker threads for counting (default: one per core)
+ *     --enumerate    Passes every tour to a visitor that checks it, instead of only counting
+ *
+ * Each option may be repeated. Without any board, runs --open 5x5 --closed 6x6 --find 8 --find 1000.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "../engine/KnightTour.hpp"
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    struct Board {
+        int rows;
+        int columns;
+        bool closed;
+    };
+
+    double secondsSince(const Clock::time_point& start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    bool parseBoard(const char* text, const bool& closed, Board& board) {
+        board.closed = closed;
+        return std::sscanf(text, "%dx%d", &board.rows, &board.columns) == 2 && board.rows > 0 && board.columns > 0 &&
+               board.rows * board.columns <= KnightTour::MAX_ENUMERATION_SQUARES;
+    }
+
+    /**
+     * @brief Counts (or enumerates and checks) the tours of one board, and prints the rate
+     */
+    void countTours(const Board& board, const int& threads, const bool& enumerate) {
+        KnightTour tours(board.rows, board.columns);
+        int starts = board.closed ? 1 : tours.squares();
+        uint64_t total = 0;
+        uint64_t invalid = 0;
+
+        Clock::time_point start = Clock::now();
+        for (int sq = 0; sq < starts; sq++) {
+            if (enumerate) {
+                total += tours.enumerateTours(sq, board.closed, threads, [&](const std::vector<uint8_t>& tour) {
+                    if (!tours.isTour(std::vector<uint32_t>(tour.begin(), tour.end()), board.closed)) { invalid++; }
+                });
+            } else {
+                total += tours.countTours(sq, board.closed, threads);
+            }
+        }
+        double seconds = secondsSince(start);
+
+        std::printf("%-6s tours %2dx%-2d %-16s %12llu tours in %8.3f s  %12.0f tours/s", board.closed ? "closed" : "open",
+                    board.rows, board.columns, board.closed ? "(first square)" : "(every square)",
+                    (unsigned long long)total, seconds, seconds > 0 ? double(total) / seconds : 0.0);
+        if (enumerate) { std::printf("  %llu invalid", (unsigned long long)invalid); }
+        std::printf("\n");
+    }
+
+    /**
+     * @brief Finds one tour of an N x N board from a corner and from the centre, and prints the time taken
+     */
+    void findTours(const int& length) {
+        Clock::time_point built = Clock::now();
+        KnightTour tours(length, length);
+        std::printf("find   %dx%d: move graph built in %.3f s\n", length, length, secondsSince(built));
+
+        int starts[2] = { tours.square(0, 0), tours.square(length / 2, length / 2) };
+        const char* names[2] = { "corner", "centre" };
+        for (int i = 0; i < 2; i++) {
+            std::vector<uint32_t> tour;
+            Clock::time_point start = Clock::now();
+            bool found = tours.findTour(starts[i], tour);
+            double seconds = secondsSince(start);
+            std::printf("find   %dx%d from the %s: %s in %.3f s\n", length, length, names[i],
+                        !found ? "no tour found" : tours.isTour(tour, false) ? "valid tour" : "INVALID TOUR", seconds);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<Board> counts;
+    std::vector<int> finds;
+    int threads = int(std::thread::hardware_concurrency());
+    bool enumerate = false;
+
+    for (int i = 1; i < argc; i++) {
+        Board board;
+        if ((std::strcmp(argv[i], "--open") == 0 || std::strcmp(argv[i], "--closed") == 0) && i + 1 < argc) {
+            bool closed = std::strcmp(argv[i], "--closed") == 0;
+            if (!parseBoard(argv[++i], closed, board)) {
+                std::fprintf(stderr, "Expected a board of at most %d squares, eg. 5x5, not %s\n", KnightTour::MAX_ENUMERATION_SQUARES, argv[i]);
+                return 1;
+            }
+            counts.push_back(board);
+        } else if (std::strcmp(argv[i], "--find") == 0 && i + 1 < argc) {
+            finds.push_back(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--enumerate") == 0) {
+            enumerate = true;
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (counts.empty() && finds.empty()) {
+        counts.push_back({ 5, 5, false });
+        counts.push_back({ 6, 6, true });
+        finds.push_back(8);
+        finds.push_back(1000);
+    }
+    if (threads < 1) { threads = 1; }
+
+    std::printf("%d threads\n", threads);
+    for (const Board& board : counts) { countTours(board, threads, enumerate); }
+    for (const int& length : finds) {
+        if (length > 0) { findTours(length); }
+    }
+    return 0;
+}